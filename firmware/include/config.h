@@ -17,11 +17,36 @@
 
 // MIDI Configuration
 #define MIDI_CHANNEL 1        // MIDI channel (1-16)
+#define DEVICE_STATE_SLOTS 8  // Number of controllers mirrored from the device
+#define MIDI_UART_RX_BUFFER_SIZE 64 // MIDI input buffer (bytes, power of two). A display refresh
+                                    // takes ~13 ms, ~40 bytes at 31250 baud, so keep it above that
+#define MIDI_UART_TX_BUFFER_SIZE 32 // MIDI output queue (bytes, power of two)
+#define MIDI_LOG_SIZE 8       // Messages kept in the MIDI traffic log
+
+// MIDI clock following and quantised sends
+#define CLOCK_BEATS_PER_BAR     4     // Beats per bar for QUANTIZE_BAR
+#define CLOCK_FILTER_WEIGHT     8     // Clock jitter filter (higher is smoother, slower to follow)
+#define CLOCK_TIMEOUT_MS      500     // Clock is considered stopped after this long without a tick
+#define QUANTIZE_QUEUE_SIZE     4     // Quantised messages that can wait for a boundary
+#define CLOCK_REPORT_INTERVAL  50     // How often quantised send results are checked (ms)
+
+// Uncomment to measure executeCommand-to-UART cost in CPU cycles (Timer1, diagnostics page).
+// Only the current path is instrumented, no figure for the old MIDI library / HardwareSerial
+// path has been taken yet, so that comparison is still open.
+// #define MIDI_TX_PROFILE
 
 // Programming mode timings
 #define HOLD_TIME_FOR_PROGRAM   5000  // Time to hold switch for programming mode (ms)
 #define PROGRAM_TIMEOUT        10000  // Timeout for programming mode (ms)
 
+// Diagnostics page, shown by pressing both chord switches together
+#define DIAG_CHORD_SWITCH_1     1     // First switch of the chord
+#define DIAG_CHORD_SWITCH_2     4     // Second switch of the chord
+#define MIDI_CHORD_SWITCH_1     2     // First switch of the chord that opens the MIDI link pages
+#define MIDI_CHORD_SWITCH_2     3     // Second switch of the MIDI link chord
+#define DIAG_REFRESH_INTERVAL 500     // Diagnostics page refresh interval (ms)
+#define DIAG_PAGE_COUNT         5     // Pages shown before returning to normal mode
+
 // EEPROM addresses for storing footswitch assignments
 #define EEPROM_VALID_FLAG      0   // Address to store validation flag
 #define EEPROM_FS1_COMMAND     1   // Address to store FS1 command index
@@ -30,6 +55,11 @@
 #define EEPROM_FS4_COMMAND     4   // Address to store FS4 command index
 #define EEPROM_VALID_VALUE     42  // Value to indicate EEPROM has been initialized
 
+// Scheduler
+#define SCHEDULER_MAX_TASKS     9     // Maximum number of scheduled tasks
+#define INPUT_SCAN_INTERVAL     1     // Footswitch scan interval (ms)
+#define MIDI_POLL_INTERVAL      1     // MIDI input poll interval (ms)
+
 // Debounce time in milliseconds
 #define DEBOUNCE_TIME 50
 
@@ -0,0 +1,170 @@
+# PlatformIO pre-build script: compresses the command names in
+# src/command_names.txt into src/command_names.h.
+#
+# Names are stored as code sequences in PROGMEM. Codes 0x01-0x7F are literal
+# characters, 0x80 + n expands dictionary token n and 0x00 ends the name.
+# The firmware decodes them a character at a time straight into a Print.
+#
+# Can also be run by hand: python scripts/command_names.py
+
+import os
+import sys
+
+SOURCE = os.path.join("src", "command_names.txt")
+OUTPUT = os.path.join("src", "command_names.h")
+
+TOKEN_BASE = 0x80
+MAX_TOKENS = 0x7F
+MIN_TOKEN_LENGTH = 2
+# Each token costs its bytes, a terminator and a 2 byte offset
+TOKEN_OVERHEAD = 3
+
+
+def read_names(path):
+    names = []
+    with open(path) as source:
+        for number, line in enumerate(source, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            identifier, separator, text = line.partition("=")
+            if not separator:
+                raise ValueError("%s:%d: expected 'identifier = text'" % (path, number))
+            text = text.strip()
+            if any(ord(char) < 0x20 or ord(char) >= TOKEN_BASE for char in text):
+                raise ValueError("%s:%d: names must be printable ASCII" % (path, number))
+            names.append((identifier.strip(), text))
+    return names
+
+
+def split_literals(text):
+    # Runs of literal characters between tokens already placed (tokens are chars >= TOKEN_BASE)
+    run = ""
+    for char in text:
+        if ord(char) >= TOKEN_BASE:
+            if run:
+                yield run
+            run = ""
+        else:
+            run += char
+    if run:
+        yield run
+
+
+def build_dictionary(texts):
+    # Greedily pick the substring that saves the most bytes, until nothing saves any
+    encoded = list(texts)
+    tokens = []
+    while len(tokens) < MAX_TOKENS:
+        counts = {}
+        for text in encoded:
+            for run in split_literals(text):
+                for start in range(len(run)):
+                    for end in range(start + MIN_TOKEN_LENGTH, len(run) + 1):
+                        candidate = run[start:end]
+                        counts[candidate] = counts.get(candidate, 0) + 1
+        best, best_saving = None, 0
+        for candidate, count in sorted(counts.items()):
+            # Count non-overlapping uses, which is what replacement will get
+            uses = sum(text.count(candidate) for text in encoded) if count > 1 else count
+            saving = uses * (len(candidate) - 1) - (len(candidate) + TOKEN_OVERHEAD)
+            if saving > best_saving:
+                best, best_saving = candidate, saving
+        if best is None:
+            break
+        code = chr(TOKEN_BASE + len(tokens))
+        tokens.append(best)
+        encoded = [text.replace(best, code) for text in encoded]
+    return tokens, encoded
+
+
+def decode(codes, tokens):
+    return "".join(tokens[ord(char) - TOKEN_BASE] if ord(char) >= TOKEN_BASE else char for char in codes)
+
+
+def byte_list(values):
+    return ", ".join("0x%02X" % value for value in values)
+
+
+def c_comment(text):
+    return text.replace("*/", "* /")
+
+
+def generate(project_dir):
+    names = read_names(os.path.join(project_dir, SOURCE))
+    unique_texts = []
+    for _, text in names:
+        if text not in unique_texts:
+            unique_texts.append(text)
+
+    tokens, encoded = build_dictionary(unique_texts)
+
+    # Every name must decode back to its source text
+    for text, codes in zip(unique_texts, encoded):
+        if decode(codes, tokens) != text:
+            raise ValueError("command name '%s' does not round-trip" % text)
+
+    lines = [
+        "// Generated by scripts/command_names.py from command_names.txt - do not edit",
+        "#ifndef COMMAND_NAMES_H",
+        "#define COMMAND_NAMES_H",
+        "",
+        "#include <Arduino.h>",
+        "#include <avr/pgmspace.h>",
+        "",
+        "// Dictionary tokens, each null terminated",
+        "const char commandNameTokens[] PROGMEM = {",
+    ]
+    token_offsets = []
+    offset = 0
+    for token in tokens:
+        token_offsets.append(offset)
+        lines.append("  %s, 0x00, // \"%s\"" % (byte_list(ord(char) for char in token), token))
+        offset += len(token) + 1
+    if not tokens:
+        lines.append("  0x00")
+    lines += [
+        "};",
+        "",
+        "// Offset of each token in commandNameTokens",
+        "const uint16_t commandNameTokenOffsets[] PROGMEM = {",
+        "  " + (", ".join(str(value) for value in token_offsets) or "0"),
+        "};",
+        "",
+        "// Names as code sequences: 0x01-0x7F literal, 0x80 + n token n, 0x00 end",
+        "const uint8_t commandNameCodes[] PROGMEM = {",
+    ]
+    text_offsets = {}
+    offset = 0
+    for text, codes in zip(unique_texts, encoded):
+        text_offsets[text] = offset
+        lines.append("  %s, 0x00, // \"%s\"" % (byte_list(ord(char) for char in codes), c_comment(text)))
+        offset += len(codes) + 1
+    lines += [
+        "};",
+        "",
+        "// Offset of each name in commandNameCodes",
+    ]
+    for identifier, text in names:
+        lines.append("const uint16_t %s = %d;" % (identifier, text_offsets[text]))
+    lines += ["", "#endif // COMMAND_NAMES_H", ""]
+
+    output_path = os.path.join(project_dir, OUTPUT)
+    content = "\n".join(lines)
+    if not os.path.exists(output_path) or open(output_path).read() != content:
+        with open(output_path, "w") as output:
+            output.write(content)
+
+    # Flash used by one PROGMEM string per identifier, against the compressed tables
+    plain_size = sum(len(text) + 1 for _, text in names)
+    compressed_size = offset + sum(len(token) + 1 for token in tokens) + 2 * len(tokens)
+    print("Command names: %d bytes as plain strings, %d bytes compressed (%d tokens), %d bytes saved"
+          % (plain_size, compressed_size, len(tokens), plain_size - compressed_size))
+
+
+try:
+    Import("env")
+    generate(env.subst("$PROJECT_DIR"))
+except NameError:
+    # Run by hand
+    generate(os.path.join(os.path.dirname(os.path.abspath(sys.argv[0])), ".."))
@@ -0,0 +1,104 @@
+# PlatformIO post-build script: reports .data/.bss/flash use per module and
+# fails the build when the firmware exceeds its memory budget.
+#
+# Runtime RAM that the linker cannot see is reserved through project options:
+#   custom_ram_heap_reserve  - heap allocations (SSD1306 frame buffer)
+#   custom_ram_stack_reserve - minimum stack space left for the firmware
+
+import os
+import subprocess
+from collections import defaultdict
+
+Import("env")
+
+# Symbols at or above this address live in SRAM in the AVR ELF address space
+RAM_ADDRESS_BASE = 0x800000
+
+
+def tool(name):
+    # avr-gcc -> avr-nm / avr-size next to the compiler
+    return env.subst("$CC").replace("gcc", name)
+
+
+def module_name(location):
+    # nm -l reports "file:line" from the debug info; group by source file
+    if not location:
+        return "(unattributed)"
+    return os.path.basename(location.rsplit(":", 1)[0])
+
+
+def collect_symbols(elf):
+    output = subprocess.check_output(
+        [tool("nm"), "--size-sort", "-S", "-l", "-C", elf],
+        universal_newlines=True,
+    )
+    usage = defaultdict(lambda: {"data": 0, "bss": 0, "flash": 0})
+    for line in output.splitlines():
+        location = None
+        if "\t" in line:
+            line, location = line.split("\t", 1)
+        fields = line.split(None, 3)
+        if len(fields) < 4:
+            continue
+        address, size, kind = int(fields[0], 16), int(fields[1], 16), fields[2].lower()
+        module = usage[module_name(location)]
+        if address >= RAM_ADDRESS_BASE:
+            if kind == "b":
+                module["bss"] += size
+            else:
+                # Initialised data takes SRAM and its initialiser takes flash
+                module["data"] += size
+                module["flash"] += size
+        elif kind in ("t", "r", "d", "w"):
+            module["flash"] += size
+    return usage
+
+
+def section_totals(elf):
+    output = subprocess.check_output([tool("size"), "-A", elf], universal_newlines=True)
+    totals = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith("."):
+            totals[fields[0]] = int(fields[1])
+    return totals
+
+
+def report(source, target, env):
+    elf = str(source[0])
+    usage = collect_symbols(elf)
+    totals = section_totals(elf)
+
+    print("")
+    print("Memory use per module (bytes)")
+    print("%-40s %6s %6s %6s" % ("Module", ".data", ".bss", "flash"))
+    for name, module in sorted(usage.items(), key=lambda item: -(item[1]["data"] + item[1]["bss"])):
+        if module["data"] or module["bss"] or module["flash"]:
+            print("%-40s %6d %6d %6d" % (name[-40:], module["data"], module["bss"], module["flash"]))
+
+    board = env.BoardConfig()
+    ram_size = int(board.get("upload.maximum_ram_size", 2048))
+    flash_size = int(board.get("upload.maximum_size", 30720))
+    heap_reserve = int(env.GetProjectOption("custom_ram_heap_reserve", "0"))
+    stack_reserve = int(env.GetProjectOption("custom_ram_stack_reserve", "0"))
+
+    static_ram = totals.get(".data", 0) + totals.get(".bss", 0) + totals.get(".noinit", 0)
+    flash_used = totals.get(".text", 0) + totals.get(".data", 0)
+    ram_budget = ram_size - heap_reserve - stack_reserve
+
+    print("")
+    print("Static RAM: %d / %d bytes (heap reserve %d, stack reserve %d)"
+          % (static_ram, ram_budget, heap_reserve, stack_reserve))
+    print("Flash:      %d / %d bytes" % (flash_used, flash_size))
+    print("")
+
+    if static_ram > ram_budget:
+        print("Error: static RAM exceeds budget by %d bytes" % (static_ram - ram_budget))
+        return 1
+    if flash_used > flash_size:
+        print("Error: flash exceeds budget by %d bytes" % (flash_used - flash_size))
+        return 1
+    return 0
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report)
@@ -0,0 +1,214 @@
+#include "clock_follower.h"
+#include "midi_controller.h"
+#include <util/atomic.h>
+
+// MIDI clock resolution
+#define TICKS_PER_BEAT 24
+
+// Time to transmit one byte at 31250 baud (10 bits)
+#define MIDI_BYTE_TIME_US 320
+
+// Period of the Timer0 compare interrupt that sends quantised messages
+#define TIMER_PERIOD_US 1024
+
+ClockFollower clockFollower;
+
+// Timer0 already overflows every 1.024 ms for millis(), its compare A interrupt
+// is free and gives a tick of the same rate for quantised sends
+ISR(TIMER0_COMPA_vect) {
+  clockFollower.handleTimer(micros());
+}
+
+void ClockFollower::begin() {
+  OCR0A = 0x80;
+  TIMSK0 |= _BV(OCIE0A);
+}
+
+void ClockFollower::handleRealtime(uint8_t status, unsigned long time) {
+  switch (status) {
+    case midi::Clock:
+      handleClock(time);
+      break;
+      
+    case midi::Start:
+      // The next clock is the first downbeat, so waiting sends lose their target tick
+      flushPendingSends();
+      running = true;
+      waitingForFirstTick = true;
+      break;
+      
+    case midi::Continue:
+      running = true;
+      break;
+      
+    case midi::Stop:
+      running = false;
+      flushPendingSends();
+      break;
+      
+    default:
+      break;
+  }
+}
+
+void ClockFollower::handleClock(unsigned long time) {
+  unsigned long interval = time - lastClockTime;
+  bool haveClock = lastClockTime != 0;
+  lastClockTime = time;
+  
+  if (!haveClock || tickInterval == 0) {
+    // First tick - nothing to filter yet
+    tickInterval = haveClock ? interval : 0;
+    tickTime = time;
+  } else if (interval > tickInterval / 2 && interval < tickInterval * 2) {
+    // Smooth the interval and lock the phase gently to the incoming ticks,
+    // so sender and interrupt latency jitter doesn't move the predicted boundaries
+    tickInterval += ((long)interval - (long)tickInterval) / CLOCK_FILTER_WEIGHT;
+    unsigned long expected = tickTime + tickInterval;
+    tickTime = expected + (long)(time - expected) / CLOCK_FILTER_WEIGHT;
+    rejectedTicks = 0;
+  } else if (++rejectedTicks >= 3) {
+    // Several ticks out of range in a row - the tempo really changed
+    tickInterval = interval;
+    tickTime = time;
+    rejectedTicks = 0;
+  } else {
+    // Dropped or doubled tick - keep the phase on the raw time
+    tickTime = time;
+  }
+  
+  if (!running) {
+    return;
+  }
+  
+  if (waitingForFirstTick) {
+    tickIndex = 0;
+    tickTime = time;
+    waitingForFirstTick = false;
+  } else {
+    tickIndex++;
+  }
+  
+  // Measure the phase error of sends that were waiting for this boundary
+  for (uint8_t i = 0; i < QUANTIZE_QUEUE_SIZE; i++) {
+    PendingSend& pending = pendingSends[i];
+    if (pending.length > 0 && pending.sent && pending.targetTick == tickIndex) {
+      completeSend(pending, time);
+    }
+  }
+}
+
+void ClockFollower::handleTimer(unsigned long time) {
+  // Clock lost - no boundary tick will arrive for the waiting sends
+  if (time - lastClockTime >= CLOCK_TIMEOUT_MS * 1000UL) {
+    flushPendingSends();
+    return;
+  }
+  
+  for (uint8_t i = 0; i < QUANTIZE_QUEUE_SIZE; i++) {
+    PendingSend& pending = pendingSends[i];
+    if (pending.length == 0 || pending.sent || (long)(time - pending.dueTime) < 0) {
+      continue;
+    }
+    
+    midiController.sendMessage(pending.message, pending.length);
+    pending.sent = true;
+    pending.sendTime = time;
+    
+    if ((int32_t)(tickIndex - pending.targetTick) >= 0) {
+      // Boundary tick already arrived - we were late
+      completeSend(pending, tickTime - (tickIndex - pending.targetTick) * tickInterval);
+    }
+  }
+}
+
+void ClockFollower::completeSend(PendingSend& pending, unsigned long boundaryTime) {
+  // The device acts when the last byte has arrived
+  unsigned long arrival = pending.sendTime + pending.length * MIDI_BYTE_TIME_US;
+  long error = (long)(arrival - boundaryTime) / 100;
+  phaseError = error > 32000 ? 32000 : (error < -32000 ? -32000 : error);
+  phaseErrorReady = true;
+  pending.length = 0;
+}
+
+void ClockFollower::flushPendingSends() {
+  for (uint8_t i = 0; i < QUANTIZE_QUEUE_SIZE; i++) {
+    PendingSend& pending = pendingSends[i];
+    if (pending.length == 0) {
+      continue;
+    }
+    
+    // The switch was pressed, so send it late rather than not at all
+    if (!pending.sent) {
+      midiController.sendMessage(pending.message, pending.length);
+    }
+    pending.length = 0;
+  }
+}
+
+bool ClockFollower::schedule(const uint8_t* message, uint8_t length, uint8_t quantize) {
+  if (quantize == QUANTIZE_NONE || length > sizeof(pendingSends[0].message) || !isRunning()) {
+    return false;
+  }
+  
+  bool scheduled = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t i = 0; i < QUANTIZE_QUEUE_SIZE && !scheduled; i++) {
+      PendingSend& pending = pendingSends[i];
+      if (pending.length > 0) {
+        continue;
+      }
+      
+      // Next boundary strictly after the current tick
+      uint32_t ticksPerBoundary = quantize == QUANTIZE_BAR ? TICKS_PER_BEAT * CLOCK_BEATS_PER_BAR : TICKS_PER_BEAT;
+      uint32_t target = (tickIndex / ticksPerBoundary + 1) * ticksPerBoundary;
+      
+      // Predict when that tick arrives and start sending early enough to finish on it.
+      // The timer only checks once per period, so aim for the middle of the period.
+      memcpy(pending.message, message, length);
+      pending.length = length;
+      pending.sent = false;
+      pending.targetTick = target;
+      pending.dueTime = tickTime + (target - tickIndex) * tickInterval - length * MIDI_BYTE_TIME_US - TIMER_PERIOD_US / 2;
+      scheduled = true;
+    }
+  }
+  
+  // Queue full - the caller sends it right away
+  return scheduled;
+}
+
+bool ClockFollower::isRunning() {
+  bool result;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    result = running && !waitingForFirstTick && tickInterval != 0 &&
+             micros() - lastClockTime < CLOCK_TIMEOUT_MS * 1000UL;
+  }
+  return result;
+}
+
+uint16_t ClockFollower::getTempo() {
+  unsigned long interval;
+  unsigned long lastTime;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    interval = tickInterval;
+    lastTime = lastClockTime;
+  }
+  
+  if (interval == 0 || micros() - lastTime >= CLOCK_TIMEOUT_MS * 1000UL) {
+    return 0;
+  }
+  
+  // 60 s per minute / 24 ticks per beat, in tenths of BPM
+  return 600000000UL / TICKS_PER_BEAT / interval;
+}
+
+bool ClockFollower::takePhaseError(int16_t* error) {
+  bool ready;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    ready = phaseErrorReady;
+    *error = phaseError;
+    phaseErrorReady = false;
+  }
+  return ready;
+}
@@ -0,0 +1,71 @@
+#ifndef CLOCK_FOLLOWER_H
+#define CLOCK_FOLLOWER_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Quantise options for commands
+#define QUANTIZE_NONE  0   // Send as soon as the switch is released
+#define QUANTIZE_BEAT  1   // Send on the next beat
+#define QUANTIZE_BAR   2   // Send on the next bar (CLOCK_BEATS_PER_BAR beats)
+
+// Follows incoming MIDI clock (24 ticks per quarter note) and sends
+// quantised messages from a timer interrupt at the predicted beat or bar.
+class ClockFollower {
+  public:
+    // Start the timer interrupt used for quantised sends
+    void begin();
+    
+    // Handle a real-time byte (Clock, Start, Continue, Stop), called from the UART RX interrupt
+    void handleRealtime(uint8_t status, unsigned long time);
+    
+    // Send due quantised messages, called from the timer interrupt
+    void handleTimer(unsigned long time);
+    
+    // Queue a message (3 bytes or less) for the next beat or bar.
+    // Returns false if the clock isn't running, the caller should send it right away.
+    bool schedule(const uint8_t* message, uint8_t length, uint8_t quantize);
+    
+    // True while clock is arriving after a Start or Continue
+    bool isRunning();
+    
+    // Tempo in tenths of BPM, 0 if no clock is arriving
+    uint16_t getTempo();
+    
+    // Get the phase error of the last completed quantised send (tenths of ms, positive is late).
+    // Returns true once per send.
+    bool takePhaseError(int16_t* error);
+    
+  private:
+    // Quantised message waiting to be sent, or sent and waiting for its boundary tick
+    struct PendingSend {
+      uint8_t message[3];
+      uint8_t length;        // 0 when the slot is free
+      bool sent;
+      uint32_t targetTick;
+      unsigned long dueTime;
+      unsigned long sendTime;
+    };
+    
+    volatile unsigned long tickTime = 0;      // Filtered time of the last tick (micros)
+    volatile unsigned long lastClockTime = 0; // Raw time of the last tick (micros)
+    volatile unsigned long tickInterval = 0;  // Filtered time between ticks (micros)
+    volatile uint32_t tickIndex = 0;          // Ticks since Start, 0 is the first downbeat
+    volatile uint8_t rejectedTicks = 0;
+    volatile bool running = false;
+    volatile bool waitingForFirstTick = false;
+    
+    PendingSend pendingSends[QUANTIZE_QUEUE_SIZE];
+    volatile int16_t phaseError = 0;
+    volatile bool phaseErrorReady = false;
+    
+    void handleClock(unsigned long time);
+    void completeSend(PendingSend& pending, unsigned long boundaryTime);
+    
+    // Send anything not yet sent and free every slot (on Start, Stop or a lost clock)
+    void flushPendingSends();
+};
+
+extern ClockFollower clockFollower;
+
+#endif // CLOCK_FOLLOWER_H
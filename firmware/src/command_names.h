@@ -0,0 +1,128 @@
+// Generated by scripts/command_names.py from command_names.txt - do not edit
+#ifndef COMMAND_NAMES_H
+#define COMMAND_NAMES_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// Dictionary tokens, each null terminated
+const char commandNameTokens[] PROGMEM = {
+  0x4C, 0x6F, 0x6F, 0x70, 0x00, // "Loop"
+  0x53, 0x63, 0x65, 0x6E, 0x65, 0x20, 0x00, // "Scene "
+  0x65, 0x72, 0x20, 0x00, // "er "
+  0x50, 0x72, 0x65, 0x73, 0x65, 0x74, 0x00, // "Preset"
+  0x2F, 0x53, 0x74, 0x6F, 0x00, // "/Sto"
+  0x45, 0x78, 0x74, 0x00, // "Ext"
+  0x54, 0x75, 0x6E, 0x00, // "Tun"
+  0x52, 0x65, 0x00, // "Re"
+  0x54, 0x6F, 0x67, 0x67, 0x6C, 0x65, 0x00, // "Toggle"
+};
+
+// Offset of each token in commandNameTokens
+const uint16_t commandNameTokenOffsets[] PROGMEM = {
+  0, 5, 12, 16, 23, 28, 32, 36, 39
+};
+
+// Names as code sequences: 0x01-0x7F literal, 0x80 + n token n, 0x00 end
+const uint8_t commandNameCodes[] PROGMEM = {
+  0x86, 0x82, 0x88, 0x00, // "Tuner Toggle"
+  0x86, 0x65, 0x72, 0x00, // "Tuner"
+  0x86, 0x82, 0x57, 0x68, 0x69, 0x6C, 0x65, 0x20, 0x48, 0x65, 0x6C, 0x64, 0x00, // "Tuner While Held"
+  0x86, 0x48, 0x6F, 0x6C, 0x64, 0x00, // "TunHold"
+  0x83, 0x2F, 0x53, 0x63, 0x65, 0x6E, 0x65, 0x84, 0x6D, 0x70, 0x00, // "Preset/Scene/Stomp"
+  0x4D, 0x6F, 0x64, 0x65, 0x00, // "Mode"
+  0x47, 0x69, 0x67, 0x20, 0x56, 0x69, 0x65, 0x77, 0x20, 0x88, 0x00, // "Gig View Toggle"
+  0x47, 0x69, 0x67, 0x56, 0x69, 0x65, 0x77, 0x00, // "GigView"
+  0x42, 0x61, 0x6E, 0x6B, 0x20, 0x53, 0x65, 0x6C, 0x65, 0x63, 0x74, 0x00, // "Bank Select"
+  0x42, 0x61, 0x6E, 0x6B, 0x53, 0x65, 0x6C, 0x00, // "BankSel"
+  0x81, 0x41, 0x00, // "Scene A"
+  0x81, 0x42, 0x00, // "Scene B"
+  0x81, 0x43, 0x00, // "Scene C"
+  0x81, 0x44, 0x00, // "Scene D"
+  0x81, 0x45, 0x00, // "Scene E"
+  0x81, 0x46, 0x00, // "Scene F"
+  0x81, 0x47, 0x00, // "Scene G"
+  0x81, 0x48, 0x00, // "Scene H"
+  0x80, 0x82, 0x50, 0x61, 0x72, 0x61, 0x6D, 0x73, 0x00, // "Looper Params"
+  0x80, 0x50, 0x72, 0x6D, 0x00, // "LoopPrm"
+  0x80, 0x82, 0x44, 0x75, 0x70, 0x6C, 0x69, 0x63, 0x61, 0x74, 0x65, 0x00, // "Looper Duplicate"
+  0x80, 0x44, 0x75, 0x70, 0x00, // "LoopDup"
+  0x80, 0x82, 0x4F, 0x6E, 0x65, 0x20, 0x53, 0x68, 0x6F, 0x74, 0x00, // "Looper One Shot"
+  0x80, 0x4F, 0x6E, 0x65, 0x00, // "LoopOne"
+  0x80, 0x82, 0x48, 0x61, 0x6C, 0x66, 0x20, 0x53, 0x70, 0x65, 0x65, 0x64, 0x00, // "Looper Half Speed"
+  0x80, 0x48, 0x6C, 0x66, 0x00, // "LoopHlf"
+  0x80, 0x82, 0x50, 0x75, 0x6E, 0x63, 0x68, 0x20, 0x49, 0x6E, 0x2F, 0x4F, 0x75, 0x74, 0x00, // "Looper Punch In/Out"
+  0x80, 0x50, 0x75, 0x6E, 0x00, // "LoopPun"
+  0x80, 0x82, 0x87, 0x63, 0x6F, 0x72, 0x64, 0x84, 0x70, 0x00, // "Looper Record/Stop"
+  0x80, 0x87, 0x63, 0x00, // "LoopRec"
+  0x80, 0x82, 0x87, 0x63, 0x2F, 0x44, 0x75, 0x62, 0x84, 0x70, 0x00, // "Looper Rec/Dub/Stop"
+  0x80, 0x52, 0x44, 0x53, 0x00, // "LoopRDS"
+  0x80, 0x82, 0x50, 0x6C, 0x61, 0x79, 0x84, 0x70, 0x00, // "Looper Play/Stop"
+  0x80, 0x50, 0x6C, 0x79, 0x00, // "LoopPly"
+  0x80, 0x82, 0x87, 0x76, 0x65, 0x72, 0x73, 0x65, 0x00, // "Looper Reverse"
+  0x80, 0x87, 0x76, 0x00, // "LoopRev"
+  0x83, 0x20, 0x31, 0x00, // "Preset 1"
+  0x50, 0x72, 0x73, 0x74, 0x20, 0x31, 0x00, // "Prst 1"
+  0x83, 0x20, 0x32, 0x00, // "Preset 2"
+  0x50, 0x72, 0x73, 0x74, 0x20, 0x32, 0x00, // "Prst 2"
+  0x85, 0x20, 0x4E, 0x6F, 0x74, 0x65, 0x20, 0x54, 0x72, 0x69, 0x67, 0x67, 0x65, 0x72, 0x00, // "Ext Note Trigger"
+  0x85, 0x4E, 0x6F, 0x74, 0x65, 0x00, // "ExtNote"
+  0x85, 0x20, 0x4E, 0x52, 0x50, 0x4E, 0x20, 0x87, 0x73, 0x65, 0x74, 0x00, // "Ext NRPN Reset"
+  0x85, 0x4E, 0x52, 0x50, 0x4E, 0x00, // "ExtNRPN"
+};
+
+// Offset of each name in commandNameCodes
+const uint16_t tunerToggleName = 0;
+const uint16_t tunerShortName = 4;
+const uint16_t tunerHoldName = 8;
+const uint16_t tunerHoldShortName = 21;
+const uint16_t presetSceneStompName = 27;
+const uint16_t modeShortName = 38;
+const uint16_t gigViewToggleName = 43;
+const uint16_t gigViewShortName = 54;
+const uint16_t bankSelectName = 62;
+const uint16_t bankSelectShortName = 74;
+const uint16_t sceneAName = 82;
+const uint16_t sceneAShortName = 82;
+const uint16_t sceneBName = 85;
+const uint16_t sceneBShortName = 85;
+const uint16_t sceneCName = 88;
+const uint16_t sceneCShortName = 88;
+const uint16_t sceneDName = 91;
+const uint16_t sceneDShortName = 91;
+const uint16_t sceneEName = 94;
+const uint16_t sceneEShortName = 94;
+const uint16_t sceneFName = 97;
+const uint16_t sceneFShortName = 97;
+const uint16_t sceneGName = 100;
+const uint16_t sceneGShortName = 100;
+const uint16_t sceneHName = 103;
+const uint16_t sceneHShortName = 103;
+const uint16_t looperParamsName = 106;
+const uint16_t looperParamsShortName = 115;
+const uint16_t looperDuplicateName = 120;
+const uint16_t looperDuplicateShortName = 132;
+const uint16_t looperOneShotName = 137;
+const uint16_t looperOneShotShortName = 148;
+const uint16_t looperHalfSpeedName = 153;
+const uint16_t looperHalfSpeedShortName = 166;
+const uint16_t looperPunchName = 171;
+const uint16_t looperPunchShortName = 186;
+const uint16_t looperRecordName = 191;
+const uint16_t looperRecordShortName = 201;
+const uint16_t looperRecordDubName = 205;
+const uint16_t looperRecordDubShortName = 216;
+const uint16_t looperPlayStopName = 221;
+const uint16_t looperPlayStopShortName = 230;
+const uint16_t looperReverseName = 235;
+const uint16_t looperReverseShortName = 244;
+const uint16_t preset1Name = 248;
+const uint16_t preset1ShortName = 252;
+const uint16_t preset2Name = 259;
+const uint16_t preset2ShortName = 263;
+const uint16_t extTriggerName = 270;
+const uint16_t extTriggerShortName = 285;
+const uint16_t extNrpnResetName = 291;
+const uint16_t extNrpnResetShortName = 303;
+
+#endif // COMMAND_NAMES_H
@@ -2,7 +2,7 @@
 #include "midi_controller.h"
 #include "../include/config.h"
 #include <EEPROM.h>
-#include "display.h"
+#include "command_names.h" // Generated from command_names.txt at build time
 
 #define ARRAY_LENGTH(x) (sizeof(x) / sizeof((x)[0]))
 
@@ -21,49 +21,11 @@
 #define QC_LOOPER_REVERSE_CC    55  // Looper enable/disable reverse (127)
 #define QC_LOOPER_UNDOREDO_CC   56  // Looper undo/redo (127)
 
-// Define strings in PROGMEM
-const char tunerToggleName[] PROGMEM = "Tuner Toggle";
-const char tunerShortName[] PROGMEM = "Tuner";
-const char presetSceneStompName[] PROGMEM = "Preset/Scene/Stomp";
-const char modeShortName[] PROGMEM = "Mode";
-const char gigViewToggleName[] PROGMEM = "Gig View Toggle";
-const char gigViewShortName[] PROGMEM = "GigView";
-const char bankSelectName[] PROGMEM = "Bank Select";
-const char bankSelectShortName[] PROGMEM = "BankSel";
-const char sceneAName[] PROGMEM = "Scene A";
-const char sceneAShortName[] PROGMEM = "Scene A";
-const char sceneBName[] PROGMEM = "Scene B";
-const char sceneBShortName[] PROGMEM = "Scene B";
-const char sceneCName[] PROGMEM = "Scene C";
-const char sceneCShortName[] PROGMEM = "Scene C";
-const char sceneDName[] PROGMEM = "Scene D";
-const char sceneDShortName[] PROGMEM = "Scene D";
-const char sceneEName[] PROGMEM = "Scene E";
-const char sceneEShortName[] PROGMEM = "Scene E";
-const char sceneFName[] PROGMEM = "Scene F";
-const char sceneFShortName[] PROGMEM = "Scene F";
-const char sceneGName[] PROGMEM = "Scene G";
-const char sceneGShortName[] PROGMEM = "Scene G";
-const char sceneHName[] PROGMEM = "Scene H";
-const char sceneHShortName[] PROGMEM = "Scene H";
-const char looperParamsName[] PROGMEM = "Looper Params";
-const char looperParamsShortName[] PROGMEM = "LoopPrm";
-const char looperDuplicateName[] PROGMEM = "Looper Duplicate";
-const char looperDuplicateShortName[] PROGMEM = "LoopDup";
-const char looperOneShotName[] PROGMEM = "Looper One Shot";
-const char looperOneShotShortName[] PROGMEM = "LoopOne";
-const char looperHalfSpeedName[] PROGMEM = "Looper Half Speed";
-const char looperHalfSpeedShortName[] PROGMEM = "LoopHlf";
-const char looperPunchName[] PROGMEM = "Looper Punch In/Out";
-const char looperPunchShortName[] PROGMEM = "LoopPun";
-const char looperRecordName[] PROGMEM = "Looper Record/Stop";
-const char looperRecordShortName[] PROGMEM = "LoopRec";
-const char looperRecordDubName[] PROGMEM = "Looper Rec/Dub/Stop";
-const char looperRecordDubShortName[] PROGMEM = "LoopRDS";
-const char looperPlayStopName[] PROGMEM = "Looper Play/Stop";
-const char looperPlayStopShortName[] PROGMEM = "LoopPly";
-const char looperReverseName[] PROGMEM = "Looper Reverse";
-const char looperReverseShortName[] PROGMEM = "LoopRev";
+// Second device (drum machine or synth) on its own channel
+#define EXT_DEVICE_CHANNEL      2   // MIDI channel of the second device
+#define EXT_TRIGGER_NOTE        36  // Note played by the trigger command (C2, kick on most drum maps)
+#define EXT_NRPN_PARAM_MSB      0   // NRPN parameter reset by the NRPN command
+#define EXT_NRPN_PARAM_LSB      1
 
 // Table of available MIDI commands
 const MidiCommand commandTable[] PROGMEM = {
@@ -71,17 +33,18 @@ const MidiCommand commandTable[] PROGMEM = {
   {tunerToggleName, tunerShortName, TYPE_CC_TOGGLE, QC_TUNER_CC, 127, 0, 0, true},
   {presetSceneStompName, modeShortName, TYPE_CC_CYCLE, QC_MODE_SWITCH_CC, 1, 2, 0, true},
   {gigViewToggleName, gigViewShortName, TYPE_CC_TOGGLE, QC_GIG_VIEW_CC, 127, 0, 0, true},
-  {bankSelectName, bankSelectShortName, TYPE_CC_TOGGLE, QC_GIG_VIEW_CC, 0, 1, 0, true},
-
-  // Scene select commands
-  {sceneAName, sceneAShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 0, 0, 0, false},
-  {sceneBName, sceneBShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 1, 0, 0, false},
-  {sceneCName, sceneCShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 2, 0, 0, false},
-  {sceneDName, sceneDShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 3, 0, 0, false},
-  {sceneEName, sceneEShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 4, 0, 0, false},
-  {sceneFName, sceneFShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 5, 0, 0, false},
-  {sceneGName, sceneGShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 6, 0, 0, false},
-  {sceneHName, sceneHShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 7, 0, 0, false},
+  // Shares the Gig View controller with different values, so the device state can't be mirrored for it
+  {bankSelectName, bankSelectShortName, TYPE_CC_TOGGLE, QC_GIG_VIEW_CC, 0, 1, 0, false},
+
+  // Scene select commands (tracked, so selecting the scene the device is already on sends nothing)
+  {sceneAName, sceneAShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 0, 0, 0, true},
+  {sceneBName, sceneBShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 1, 0, 0, true},
+  {sceneCName, sceneCShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 2, 0, 0, true},
+  {sceneDName, sceneDShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 3, 0, 0, true},
+  {sceneEName, sceneEShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 4, 0, 0, true},
+  {sceneFName, sceneFShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 5, 0, 0, true},
+  {sceneGName, sceneGShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 6, 0, 0, true},
+  {sceneHName, sceneHShortName, TYPE_CC_FIXED, QC_SCENE_SELECT_CC, 7, 0, 0, true},
 
   // Looper commands
   {looperParamsName, looperParamsShortName, TYPE_CC_TOGGLE, QC_LOOPER_PARAMETERS_CC, 0, 127, 0, true},
@@ -89,18 +52,45 @@ const MidiCommand commandTable[] PROGMEM = {
   {looperOneShotName, looperOneShotShortName, TYPE_CC_FIXED, QC_LOOPER_ONESHOT_CC, 127, 0, 0, false},
   {looperHalfSpeedName, looperHalfSpeedShortName, TYPE_CC_FIXED, QC_LOOPER_HALFSPEED_CC, 127, 0, 0, false},
   {looperPunchName, looperPunchShortName, TYPE_CC_FIXED, QC_LOOPER_PUNCH_CC, 127, 0, 0, false},
-  {looperRecordName, looperRecordShortName, TYPE_CC_FIXED, QC_LOOPER_RECORD_CC, 0, 0, 0, false},
-  {looperRecordDubName, looperRecordDubShortName, TYPE_CC_FIXED, QC_LOOPER_RECORD_CC, 127, 0, 0, false},
-  {looperPlayStopName, looperPlayStopShortName, TYPE_CC_FIXED, QC_LOOPER_PLAY_STOP_CC, 127, 0, 0, false},
+  {looperRecordName, looperRecordShortName, TYPE_CC_FIXED, QC_LOOPER_RECORD_CC, 0, 0, 0, false, 0, QUANTIZE_BAR},
+  {looperRecordDubName, looperRecordDubShortName, TYPE_CC_FIXED, QC_LOOPER_RECORD_CC, 127, 0, 0, false, 0, QUANTIZE_BAR},
+  {looperPlayStopName, looperPlayStopShortName, TYPE_CC_FIXED, QC_LOOPER_PLAY_STOP_CC, 127, 0, 0, false, 0, QUANTIZE_BAR},
   {looperReverseName, looperReverseShortName, TYPE_CC_FIXED, QC_LOOPER_REVERSE_CC, 127, 0, 0, false},
+
+  // Preset select commands (Program Change within the current bank)
+  {preset1Name, preset1ShortName, TYPE_PROGRAM_CHANGE, 0, 0, 0, 0, false},
+  {preset2Name, preset2ShortName, TYPE_PROGRAM_CHANGE, 0, 1, 0, 0, false},
+
+  // Second device commands
+  {extTriggerName, extTriggerShortName, TYPE_NOTE, EXT_TRIGGER_NOTE, 127, 0, 0, false, EXT_DEVICE_CHANNEL},
+  {extNrpnResetName, extNrpnResetShortName, TYPE_NRPN, EXT_NRPN_PARAM_MSB, EXT_NRPN_PARAM_LSB, 0, 0, false, EXT_DEVICE_CHANNEL},
+
+  // Momentary commands (new rows go at the end, footswitch assignments are saved as table indices)
+  {tunerHoldName, tunerHoldShortName, TYPE_CC_MOMENTARY, QC_TUNER_CC, 127, 0, 0, false},
 };
 
 // Array of footswitch assignments - which command index is assigned to each footswitch
 uint8_t footswitchAssignments[4] = {0, 1, 2, 3}; // Default assignments
 
+// Footswitches whose command press was sent and still needs its release
+bool footswitchPressSent[4] = {false};
+
 // Array to track state for each command
 uint8_t commandStates[ARRAY_LENGTH(commandTable)] = {0}; // Initialize all states to 0
 
+// Pre-encoded wire messages for the commands assigned to the footswitches.
+// Slot 0-2 is the message for value1-value3 (CC types), press/release (Note) or the program (PC).
+struct PreparedCommand {
+  uint8_t commandIndex;
+  uint8_t messages[3][3];
+};
+PreparedCommand preparedCommands[4] = {{0xFF}, {0xFF}, {0xFF}, {0xFF}};
+
+#ifdef MIDI_TX_PROFILE
+// Cycles spent in the last executeCommand call
+uint16_t lastCommandCycles = 0;
+#endif
+
 // Get the number of available commands
 uint8_t getCommandCount() {
   return sizeof(commandTable) / sizeof(MidiCommand);
@@ -117,22 +107,130 @@ MidiCommand getCommand(uint8_t index) {
   return result;
 }
 
-// Get command name for display
-const __FlashStringHelper* getCommandName(uint8_t index) {
+// Print a compressed name, expanding dictionary tokens straight into the output
+static void printName(Print& out, uint16_t offset) {
+  const uint8_t* code = commandNameCodes + offset;
+  uint8_t value;
+  while ((value = pgm_read_byte(code++)) != 0) {
+    if (value & 0x80) {
+      const char* token = commandNameTokens + pgm_read_word(&commandNameTokenOffsets[value & 0x7F]);
+      char c;
+      while ((c = pgm_read_byte(token++)) != 0) {
+        out.write(c);
+      }
+    } else {
+      out.write(value);
+    }
+  }
+}
+
+// Print command name for display
+void printCommandName(Print& out, uint8_t index) {
   MidiCommand cmd = getCommand(index);
-  return reinterpret_cast<const __FlashStringHelper*>(cmd.name);
+  printName(out, cmd.name);
 }
 
-// Get short command name for display
-const __FlashStringHelper* getCommandShortName(uint8_t index) {
+// Print short command name for display
+void printCommandShortName(Print& out, uint8_t index) {
   MidiCommand cmd = getCommand(index);
-  return reinterpret_cast<const __FlashStringHelper*>(cmd.shortName);
+  printName(out, cmd.shortName);
+}
+
+// Convert a device value into a command state (toggle: 0/1, cycle: 0/1/2)
+static uint8_t stateFromValue(const MidiCommand& cmd, uint8_t value) {
+  if (value == cmd.value1) {
+    return 1;
+  }
+  if (cmd.type == TYPE_CC_CYCLE && value == cmd.value2) {
+    return 2;
+  }
+  return 0;
+}
+
+// Get one of a command's values (slot 0-2 = value1-value3)
+static uint8_t valueForSlot(const MidiCommand& cmd, uint8_t slot) {
+  switch (slot) {
+    case 0:
+      return cmd.value1;
+    case 1:
+      return cmd.value2;
+    default:
+      return cmd.value3;
+  }
+}
+
+// Convert a command state into the value slot to send
+static uint8_t slotFromState(const MidiCommand& cmd, uint8_t state) {
+  switch (state) {
+    case 1:
+      return 0;
+    case 2:
+      return 1;
+    default:
+      return cmd.type == TYPE_CC_CYCLE ? 2 : 1;
+  }
+}
+
+// Encode the message a command sends for a value slot, returns its length (0 if it needs several messages)
+static uint8_t encodeCommandMessage(const MidiCommand& cmd, uint8_t slot, uint8_t* message) {
+  switch (cmd.type) {
+    case TYPE_PROGRAM_CHANGE:
+      return MidiController::encodeMessage(message, midi::ProgramChange, cmd.channel, cmd.value1, 0);
+    case TYPE_NOTE:
+      return MidiController::encodeMessage(message, slot == 0 ? midi::NoteOn : midi::NoteOff, cmd.channel,
+                                           cmd.controller, slot == 0 ? cmd.value1 : cmd.value2);
+    case TYPE_NRPN:
+      return 0;
+    default:
+      return MidiController::encodeMessage(message, midi::ControlChange, cmd.channel, cmd.controller, valueForSlot(cmd, slot));
+  }
+}
+
+// Send one of a command's messages, skipping state-tracked values the device is already in
+static void sendCommandValue(uint8_t commandIndex, const MidiCommand& cmd, uint8_t slot) {
+  // Use the message encoded when the command was assigned to a footswitch
+  const uint8_t* message = NULL;
+  for (uint8_t i = 0; i < 4; i++) {
+    if (preparedCommands[i].commandIndex == commandIndex) {
+      message = preparedCommands[i].messages[slot];
+      break;
+    }
+  }
+  
+  uint8_t encoded[3];
+  if (message == NULL) {
+    encodeCommandMessage(cmd, slot, encoded);
+    message = encoded;
+  }
+  
+  uint8_t deviceValue;
+  if (cmd.stateTracking && (message[0] & 0xF0) == midi::ControlChange &&
+      midiController.getDeviceValue(cmd.channel, cmd.controller, &deviceValue) && deviceValue == message[2]) {
+    return;
+  }
+  
+  // Quantised commands are sent from the clock timer when a MIDI clock is running
+  uint8_t length = MidiController::messageLength(message[0]);
+  if (clockFollower.schedule(message, length, cmd.quantize)) {
+    return;
+  }
+  midiController.sendMessage(message, length);
+}
+
+// Get current state for a command that has already been read from the table
+static uint8_t commandState(uint8_t commandIndex, const MidiCommand& cmd) {
+  // Prefer the state reported by the device over the last value we sent
+  uint8_t deviceValue;
+  if (cmd.stateTracking && midiController.getDeviceValue(cmd.channel, cmd.controller, &deviceValue)) {
+    return stateFromValue(cmd, deviceValue);
+  }
+  return commandStates[commandIndex];
 }
 
 // Get current state for a command
 uint8_t getCommandState(uint8_t commandIndex) {
   if (commandIndex < getCommandCount()) {
-    return commandStates[commandIndex];
+    return commandState(commandIndex, getCommand(commandIndex));
   }
   return 0;
 }
@@ -144,62 +242,157 @@ void setCommandState(uint8_t commandIndex, uint8_t state) {
   }
 }
 
+// Encode the wire messages for the commands assigned to the footswitches
+void prepareFootswitchCommands() {
+  for (uint8_t i = 0; i < 4; i++) {
+    MidiCommand cmd = getCommand(footswitchAssignments[i]);
+    preparedCommands[i].commandIndex = footswitchAssignments[i];
+    for (uint8_t slot = 0; slot < 3; slot++) {
+      encodeCommandMessage(cmd, slot, preparedCommands[i].messages[slot]);
+    }
+  }
+}
+
+#ifdef MIDI_TX_PROFILE
+uint16_t getLastCommandCycles() {
+  return lastCommandCycles;
+}
+#endif
+
+// Register state-tracked controllers so device changes are mirrored
+void trackCommandStates() {
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    MidiCommand cmd = getCommand(i);
+    if (cmd.stateTracking) {
+      midiController.trackController(cmd.channel, cmd.controller);
+    }
+  }
+}
+
+// Handler for one command type, called on press (buttonState true) and release
+typedef void (*CommandHandler)(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState);
+
+// Handlers are specialised per command type so each one only does the work its type needs
+template <CommandType Type>
+void handleCommand(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState);
+
+template <>
+void handleCommand<TYPE_CC_TOGGLE>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  if (buttonState) { // Only on press
+    // Toggle state between 0 and 1
+    uint8_t state = !commandState(commandIndex, cmd);
+    setCommandState(commandIndex, state);
+    // Send the appropriate value based on state
+    sendCommandValue(commandIndex, cmd, slotFromState(cmd, state));
+  }
+}
+
+template <>
+void handleCommand<TYPE_CC_MOMENTARY>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  // Send different values on press and release
+  sendCommandValue(commandIndex, cmd, buttonState ? 0 : 1);
+}
+
+template <>
+void handleCommand<TYPE_CC_FIXED>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  if (buttonState) { // Only on press
+    // Always send the same value, unless a tracked device is already there
+    sendCommandValue(commandIndex, cmd, 0);
+  }
+}
+
+template <>
+void handleCommand<TYPE_CC_CYCLE>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  if (buttonState) { // Only on press
+    // Cycle through values: 0 -> 1 -> 2 -> 0 -> ...
+    uint8_t state = (commandState(commandIndex, cmd) + 1) % 3;
+    setCommandState(commandIndex, state);
+    
+    // Send appropriate value based on state
+    sendCommandValue(commandIndex, cmd, slotFromState(cmd, state));
+  }
+}
+
+template <>
+void handleCommand<TYPE_PROGRAM_CHANGE>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  if (buttonState) { // Only on press
+    sendCommandValue(commandIndex, cmd, 0);
+  }
+}
+
+template <>
+void handleCommand<TYPE_NOTE>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  // Note On on press, Note Off on release
+  sendCommandValue(commandIndex, cmd, buttonState ? 0 : 1);
+}
+
+template <>
+void handleCommand<TYPE_NRPN>(uint8_t commandIndex, const MidiCommand& cmd, bool buttonState) {
+  if (buttonState) { // Only on press
+    // Parameter number MSB/LSB, then data entry MSB/LSB, queued as one block
+    uint8_t message[12];
+    uint8_t length = 0;
+    length += MidiController::encodeMessage(message + length, midi::ControlChange, cmd.channel, 99, cmd.controller);
+    length += MidiController::encodeMessage(message + length, midi::ControlChange, cmd.channel, 98, cmd.value1);
+    length += MidiController::encodeMessage(message + length, midi::ControlChange, cmd.channel, 6, cmd.value2);
+    length += MidiController::encodeMessage(message + length, midi::ControlChange, cmd.channel, 38, cmd.value3);
+    midiController.sendMessage(message, length);
+  }
+}
+
+// Handler table, in CommandType order
+const CommandHandler commandHandlers[] PROGMEM = {
+  handleCommand<TYPE_CC_TOGGLE>,
+  handleCommand<TYPE_CC_MOMENTARY>,
+  handleCommand<TYPE_CC_FIXED>,
+  handleCommand<TYPE_CC_CYCLE>,
+  handleCommand<TYPE_PROGRAM_CHANGE>,
+  handleCommand<TYPE_NOTE>,
+  handleCommand<TYPE_NRPN>,
+};
+
+static_assert(ARRAY_LENGTH(commandHandlers) == COMMAND_TYPE_COUNT, "Every CommandType needs a handler");
+
 // Execute a MIDI command based on its type
 void executeCommand(uint8_t commandIndex, bool buttonState) {
+#ifdef MIDI_TX_PROFILE
+  uint16_t startCycles = TCNT1;
+#endif
+  
   // Get the command
   MidiCommand cmd = getCommand(commandIndex);
-  uint8_t currentState = getCommandState(commandIndex);
   
-  // Execute based on command type
-  switch (cmd.type) {
-    case TYPE_CC_TOGGLE:
-      if (buttonState) { // Only on press
-        // Toggle state between 0 and 1
-        currentState = !currentState;
-        setCommandState(commandIndex, currentState);
-        // Send the appropriate value based on state
-        midiController.sendControlChange(cmd.controller, currentState ? cmd.value1 : cmd.value2);
-      }
-      break;
-      
-    case TYPE_CC_MOMENTARY:
-      // Send different values on press and release
-      midiController.sendControlChange(cmd.controller, buttonState ? cmd.value1 : cmd.value2);
-      break;
-      
-    case TYPE_CC_FIXED:
-      if (buttonState) { // Only on press
-        // Always send the same value
-        midiController.sendControlChange(cmd.controller, cmd.value1);
-      }
-      break;
-      
-    case TYPE_CC_CYCLE:
-      if (buttonState) { // Only on press
-        // Cycle through values: 0 -> 1 -> 2 -> 0 -> ...
-        uint8_t valueToSend;
-        
-        // Update state (cycle through 0, 1, 2)
-        currentState = (currentState + 1) % 3;
-        setCommandState(commandIndex, currentState);
-        
-        // Send appropriate value based on state
-        switch (currentState) {
-          case 0:
-            valueToSend = cmd.value3;
-            break;
-          case 1:
-            valueToSend = cmd.value1;
-            break;
-          case 2:
-            valueToSend = cmd.value2;
-            break;
-        }
-        
-        midiController.sendControlChange(cmd.controller, valueToSend);
-      }
-      break;
+  // Dispatch to the handler for its type
+  if (cmd.type < COMMAND_TYPE_COUNT) {
+    CommandHandler handler = reinterpret_cast<CommandHandler>(pgm_read_ptr(&commandHandlers[cmd.type]));
+    handler(commandIndex, cmd, buttonState);
   }
+  
+#ifdef MIDI_TX_PROFILE
+  if (buttonState) {
+    lastCommandCycles = TCNT1 - startCycles;
+  }
+#endif
+}
+
+// Send a footswitch's command press
+void pressFootswitch(uint8_t switchNumber) {
+  executeCommand(footswitchAssignments[switchNumber - 1], true);
+  footswitchPressSent[switchNumber - 1] = true;
+}
+
+// Send a footswitch's command release if its press was sent
+void releaseFootswitch(uint8_t switchNumber) {
+  if (footswitchPressSent[switchNumber - 1]) {
+    footswitchPressSent[switchNumber - 1] = false;
+    executeCommand(footswitchAssignments[switchNumber - 1], false);
+  }
+}
+
+// Check whether a command sends on the switch press
+bool commandActsOnPress(uint8_t commandIndex) {
+  CommandType type = getCommand(commandIndex).type;
+  return type == TYPE_CC_MOMENTARY || type == TYPE_NOTE;
 }
 
 // Save footswitch assignments to EEPROM
@@ -209,6 +402,8 @@ void saveFootswitchAssignments(uint8_t fs1Cmd, uint8_t fs2Cmd, uint8_t fs3Cmd, u
   EEPROM.write(EEPROM_FS2_COMMAND, fs2Cmd);
   EEPROM.write(EEPROM_FS3_COMMAND, fs3Cmd);
   EEPROM.write(EEPROM_FS4_COMMAND, fs4Cmd);
+  
+  prepareFootswitchCommands();
 }
 
 // Load footswitch assignments from EEPROM
@@ -234,4 +429,6 @@ void loadFootswitchAssignments(uint8_t* fs1Cmd, uint8_t* fs2Cmd, uint8_t* fs3Cmd
     *fs3Cmd = 2;
     *fs4Cmd = 3;
   }
+  
+  prepareFootswitchCommands();
 }
\ No newline at end of file
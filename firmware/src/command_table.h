@@ -3,51 +3,80 @@
 
 #include <Arduino.h>
 #include <avr/pgmspace.h>
+#include "../include/config.h"
+#include "clock_follower.h"
 
 // Helper macro for defining flash strings (safe for global context)
 #define FLASH_STR(string_literal) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
 
 
-// Command types
+// Command types (each has its own handler in command_table.cpp)
 enum CommandType {
-  TYPE_CC_TOGGLE,     // Toggle between two CC values
-  TYPE_CC_MOMENTARY,  // Send one CC value on press, another on release
-  TYPE_CC_FIXED,      // Send a fixed CC value
-  TYPE_CC_CYCLE       // Cycle through multiple CC values
+  TYPE_CC_TOGGLE,       // Toggle between two CC values
+  TYPE_CC_MOMENTARY,    // Send one CC value on press, another on release
+  TYPE_CC_FIXED,        // Send a fixed CC value
+  TYPE_CC_CYCLE,        // Cycle through multiple CC values
+  TYPE_PROGRAM_CHANGE,  // Send program value1 on press
+  TYPE_NOTE,            // Note On (velocity value1) on press, Note Off (velocity value2) on release
+  TYPE_NRPN,            // Set NRPN parameter controller/value1 (MSB/LSB) to value2/value3 (MSB/LSB)
+  COMMAND_TYPE_COUNT
 };
 
 // Structure to define a MIDI command
 struct MidiCommand {
-  PGM_P name;        // Full name of the command (for programming mode)
-  PGM_P shortName;   // Short name (7 chars or less) for main display
+  uint16_t name;     // Full name of the command (for programming mode), offset in command_names.h
+  uint16_t shortName; // Short name (7 chars or less) for main display, offset in command_names.h
   CommandType type;                       // Type of command
-  uint8_t controller;                     // CC number
+  uint8_t controller;                     // CC number, note number or NRPN parameter MSB
   uint8_t value1;                         // Primary value
   uint8_t value2;                         // Secondary value (for toggle/momentary)
   uint8_t value3;                         // Optional third value (for cycle)
-  bool stateTracking;                     // Whether to track state for this command
+  bool stateTracking;                     // Whether to track state for this command (tracked commands
+                                          // sharing a controller must agree on what its values mean)
+  uint8_t channel;                        // MIDI channel (1-16), 0 to use MIDI_CHANNEL
+  uint8_t quantize;                       // QUANTIZE_NONE, QUANTIZE_BEAT or QUANTIZE_BAR (with MIDI clock)
 };
 
 // Function to execute a MIDI command
 void executeCommand(uint8_t commandIndex, bool buttonState);
 
+// Send the press of a footswitch's command (switch 1-4), remembering it so the release follows
+void pressFootswitch(uint8_t switchNumber);
+
+// Send the release of a footswitch's command, only if its press was sent
+void releaseFootswitch(uint8_t switchNumber);
+
+// Check whether a command sends on the switch press (momentary and note types) rather than on release
+bool commandActsOnPress(uint8_t commandIndex);
+
 // Get current state value for a command (for toggle and cycle types)
 uint8_t getCommandState(uint8_t commandIndex);
 
 // Set state for a command (for toggle and cycle types)
 void setCommandState(uint8_t commandIndex, uint8_t state);
 
+// Encode the wire messages for the commands assigned to the footswitches (call after assignments change)
+void prepareFootswitchCommands();
+
+#ifdef MIDI_TX_PROFILE
+// CPU cycles spent in the last executeCommand call, up to the message being queued on the UART
+uint16_t getLastCommandCycles();
+#endif
+
+// Register the controllers of state-tracked commands with the device state mirror
+void trackCommandStates();
+
 // Function to get the number of available commands
 uint8_t getCommandCount();
 
 // Function to get command by index
 MidiCommand getCommand(uint8_t index);
 
-// Get command name for a given index
-const __FlashStringHelper* getCommandName(uint8_t index);
+// Print the command name for a given index (names are compressed, so they are decoded as they print)
+void printCommandName(Print& out, uint8_t index);
 
-// Get short command name for a given index
-const __FlashStringHelper* getCommandShortName(uint8_t index);
+// Print the short command name for a given index
+void printCommandShortName(Print& out, uint8_t index);
 
 // Function to save footswitch assignments to EEPROM
 void saveFootswitchAssignments(uint8_t fs1Cmd, uint8_t fs2Cmd, uint8_t fs3Cmd, uint8_t fs4Cmd);
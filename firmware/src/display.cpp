@@ -2,13 +2,18 @@
 #include "../include/config.h"
 #include <Wire.h>
 #include "command_table.h"
+#include "memory_monitor.h"
+#include "scheduler.h"
+#include "clock_follower.h"
+#include "midi_monitor.h"
+#include "midi_uart.h"
 
 Display oled;
 
 bool Display::begin() {
   // SSD1306_SWITCHCAPVCC = generate display voltage from 3.3V internally
+  // (No error print: the serial port carries MIDI)
   if(!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-    Serial.println(F("SSD1306 allocation failed"));
     return false;
   }
   
@@ -62,22 +67,28 @@ void Display::drawFootswitchStates(bool sw1, bool sw2, bool sw3, bool sw4) {
   display.setTextSize(1);
   
   // First row - Footswitches 1 & 2
-  display.setCursor(0, 0);
-  display.print(F("1:"));
-  display.print(getCommandShortName(footswitchAssignments[0]));
-  
-  display.setCursor(64, 0);
-  display.print(F("2:"));
-  display.print(getCommandShortName(footswitchAssignments[1]));
+  drawFootswitchLabel(0, 0, 1);
+  drawFootswitchLabel(64, 0, 2);
   
   // Second row - Footswitches 3 & 4
-  display.setCursor(0, 10);
-  display.print(F("3:"));
-  display.print(getCommandShortName(footswitchAssignments[2]));
+  drawFootswitchLabel(0, 10, 3);
+  drawFootswitchLabel(64, 10, 4);
+}
+
+void Display::drawFootswitchLabel(uint8_t x, uint8_t y, uint8_t switchNumber) {
+  uint8_t commandIndex = footswitchAssignments[switchNumber - 1];
+  MidiCommand cmd = getCommand(commandIndex);
+  
+  display.setCursor(x, y);
+  display.print(switchNumber);
+  display.print(F(":"));
   
-  display.setCursor(64, 10);
-  display.print(F("4:"));
-  display.print(getCommandShortName(footswitchAssignments[3]));
+  // Show the name inverted while a tracked toggle is on in the device
+  if (cmd.type == TYPE_CC_TOGGLE && cmd.stateTracking && getCommandState(commandIndex)) {
+    display.setTextColor(SSD1306_BLACK, SSD1306_WHITE);
+  }
+  printCommandShortName(display, commandIndex);
+  display.setTextColor(SSD1306_WHITE);
 }
 
 void Display::showMidiMessage(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2, uint8_t commandIndex) {
@@ -86,7 +97,7 @@ void Display::showMidiMessage(uint8_t type, uint8_t channel, uint8_t data1, uint
   display.setCursor(0, 22);
   
   // Show command name instead of MIDI details
-  display.print(getCommandName(commandIndex));
+  printCommandName(display, commandIndex);
   
   display.display();
 }
@@ -97,7 +108,7 @@ void Display::showFunctionPreview(uint8_t commandIndex) {
   display.setCursor(0, 22);
   
   // Show command name 
-  display.print(getCommandName(commandIndex));
+  printCommandName(display, commandIndex);
   
   display.display();
 }
@@ -133,7 +144,7 @@ void Display::showProgramMode(uint8_t switchNumber, uint8_t commandIndex) {
   
   // Show command name
   display.setCursor(0, 20);
-  display.print(getCommandName(commandIndex));
+  printCommandName(display, commandIndex);
   
   display.display();
 }
@@ -144,7 +155,7 @@ void Display::flashProgramCommand(bool showText) {
   
   if (showText) {
     display.setCursor(0, 20);
-    display.print(getCommandName(selectedCommand));
+    printCommandName(display, selectedCommand);
   }
   
   display.display();
@@ -163,14 +174,11 @@ void Display::showCommandSaved(uint8_t switchNumber, uint8_t commandIndex) {
   display.print(F(" = "));
   
   display.setCursor(0, 20);
-  display.print(getCommandName(commandIndex));
+  printCommandName(display, commandIndex);
   
   display.display();
-  delay(1500); // Show for 1.5 seconds
-
-  clearMidiMessageArea(); // Clear the MIDI message area
   
-  // Return to normal mode
+  // Return to normal mode (the message stays up until the labels are redrawn)
   inProgramMode = false;
 }
 
@@ -184,8 +192,166 @@ void Display::showProgramCanceled() {
   display.println(F("CANCELED"));
   
   display.display();
-  delay(1500); // Show for 1.5 seconds
   
-  // Return to normal mode
+  // Return to normal mode (the message stays up until the labels are redrawn)
   inProgramMode = false;
+}
+
+void Display::showDiagnostics(uint8_t page) {
+  inDiagnosticsMode = true;
+  diagnosticsPage = page;
+  
+  display.clearDisplay();
+  display.setTextSize(1);
+  
+  switch (page) {
+    case 0:
+      drawMemoryDiagnostics();
+      break;
+    case 1:
+      drawTaskDiagnostics();
+      break;
+    case 2:
+      drawClockDiagnostics();
+      break;
+    case 3:
+      drawLinkDiagnostics();
+      break;
+    case 4:
+      drawMidiLog();
+      break;
+  }
+  
+  display.display();
+}
+
+void Display::drawMemoryDiagnostics() {
+  display.setCursor(0, 0);
+  display.print(F("DIAGNOSTICS"));
+  
+#ifdef MIDI_TX_PROFILE
+  // Cycles from executeCommand to the message being queued on the UART
+  display.setCursor(72, 0);
+  display.print(F("TX:"));
+  display.print(getLastCommandCycles());
+#endif
+  
+  // Free RAM now (the lowest ever is "Never used", sampling only sees the shallow stack of loop())
+  display.setCursor(0, 8);
+  display.print(F("Free:"));
+  display.print(memoryMonitor.getFreeRam());
+  
+  // Stack high-water mark from boot-time stack painting
+  display.setCursor(0, 16);
+  display.print(F("Stack max:"));
+  display.print(memoryMonitor.getStackHighWater());
+  
+  display.setCursor(0, 24);
+  display.print(F("Never used:"));
+  display.print(memoryMonitor.getStackUnused());
+}
+
+void Display::drawTaskDiagnostics() {
+  display.setCursor(0, 0);
+  display.println(F("TASK OVERRUNS"));
+  
+  // Three tasks per row, name and overrun count
+  for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+    display.setCursor((i % 3) * 43, 8 + (i / 3) * 8);
+    display.print(scheduler.getTaskName(i));
+    display.print(F(":"));
+    display.print(scheduler.getOverruns(i));
+  }
+}
+
+void Display::drawClockDiagnostics() {
+  display.setCursor(0, 0);
+  display.println(F("MIDI CLOCK"));
+  
+  display.setCursor(0, 8);
+  display.print(F("Tempo:"));
+  printTenths(clockFollower.getTempo(), false);
+  
+  display.setCursor(0, 16);
+  display.print(clockFollower.isRunning() ? F("Running") : F("Stopped"));
+}
+
+void Display::drawLinkDiagnostics() {
+  display.setCursor(0, 0);
+  display.println(F("MIDI LINK"));
+  
+  // Messages and bytes per second in each direction
+  display.setCursor(0, 8);
+  display.print(F("RX "));
+  display.print(midiMonitor.getRxMessageRate());
+  display.print(F("m/s "));
+  display.print(midiMonitor.getRxByteRate());
+  display.print(F("B/s"));
+  
+  display.setCursor(0, 16);
+  display.print(F("TX "));
+  display.print(midiMonitor.getTxMessageRate());
+  display.print(F("m/s "));
+  display.print(midiMonitor.getTxByteRate());
+  display.print(F("B/s pk"));
+  display.print(midiUart.getTxPeakDepth());
+  
+  // Overruns (incl. full RX buffer), framing errors and parser resyncs
+  display.setCursor(0, 24);
+  display.print(F("Ov"));
+  display.print(midiUart.getRxOverruns() + midiUart.getRxDropped());
+  display.print(F(" FE"));
+  display.print(midiUart.getRxFramingErrors());
+  display.print(F(" Rsy"));
+  display.print(midiMonitor.getResyncs());
+}
+
+void Display::drawMidiLog() {
+  display.setCursor(0, 0);
+  display.println(F("MIDI LOG"));
+  
+  // Most recent messages first
+  MidiMonitor::LogEntry entry;
+  for (uint8_t i = 0; i < 3 && midiMonitor.getLogEntry(i, &entry); i++) {
+    display.setCursor(0, 8 + i * 8);
+    display.print(entry.direction == MIDI_DIRECTION_TX ? F("TX ") : F("RX "));
+    printHex(entry.status);
+    display.print(F(" "));
+    printHex(entry.data1);
+    display.print(F(" "));
+    printHex(entry.data2);
+  }
+}
+
+void Display::printHex(uint8_t value) {
+  if (value < 0x10) {
+    display.print(F("0"));
+  }
+  display.print(value, HEX);
+}
+
+void Display::showQuantizeResult(uint16_t tempo, int16_t phaseError) {
+  // Write on the bottom area of the display - clear the area first
+  display.fillRect(0, 21, SCREEN_WIDTH, 11, SSD1306_BLACK);
+  display.setCursor(0, 22);
+  
+  printTenths(tempo, false);
+  display.print(F("bpm err:"));
+  printTenths(phaseError, true);
+  display.print(F("ms"));
+  
+  display.display();
+}
+
+void Display::printTenths(int16_t value, bool showSign) {
+  if (value < 0) {
+    display.print(F("-"));
+    value = -value;
+  } else if (showSign) {
+    display.print(F("+"));
+  }
+  
+  display.print(value / 10);
+  display.print(F("."));
+  display.print(value % 10);
 }
\ No newline at end of file
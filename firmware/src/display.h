@@ -40,17 +40,35 @@ class Display {
     // Show program mode canceled message
     void showProgramCanceled();
     
+    // Show a diagnostics page (0: memory use, 1: task overruns, 2: MIDI clock, 3: MIDI link, 4: MIDI log)
+    void showDiagnostics(uint8_t page);
+    
+    // Show the tempo and phase error of a quantised send in the MIDI message area
+    void showQuantizeResult(uint16_t tempo, int16_t phaseError);
+    
     // Variables for programming mode
     bool inProgramMode = false;
     uint8_t programmingSwitch = 0;
     uint8_t selectedCommand = 0;
     
+    // Diagnostics page is shown instead of the footswitch labels
+    bool inDiagnosticsMode = false;
+    uint8_t diagnosticsPage = 0;
+    
     // Track last pressed footswitch for MIDI message display
     uint8_t lastPressedSwitch = 0;
     
   private:
     Adafruit_SSD1306 display;
     void drawFootswitchStates(bool sw1, bool sw2, bool sw3, bool sw4);
+    void drawFootswitchLabel(uint8_t x, uint8_t y, uint8_t switchNumber);
+    void drawMemoryDiagnostics();
+    void drawTaskDiagnostics();
+    void drawClockDiagnostics();
+    void drawLinkDiagnostics();
+    void drawMidiLog();
+    void printHex(uint8_t value);
+    void printTenths(int16_t value, bool showSign);
 };
 
 extern Display oled;
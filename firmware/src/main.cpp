@@ -4,14 +4,15 @@
 #include "footswitches.h"
 #include "midi_controller.h"
 #include "command_table.h"
+#include "scheduler.h"
+#include "clock_follower.h"
+#include "midi_monitor.h"
 #include "../include/config.h"
 
 // Device name for display
 const char* DEVICE_NAME = "MIDI Controller";
 
-// Timing variables for programming mode
-unsigned long switchHoldStartTime = 0;
-unsigned long lastProgramActionTime = 0;
+// Hold detection for programming mode
 bool switchBeingHeld = false;
 uint8_t heldSwitch = 0;
 
@@ -20,32 +21,92 @@ uint8_t originalCommands[4];
 
 // Flash state for programming mode
 bool flashState = true;
-unsigned long lastFlashTime = 0;
 const unsigned long FLASH_INTERVAL = 500; // Flash every 500ms
 
-void setup() {
-  // Initialize I2C for OLED
-  Wire.begin();
-  
-  // Initialize the display
-  if (!oled.begin()) {
-    // If display initialization fails, we'll still continue but won't have visual feedback
+// Saved and canceled messages stay up until the display task next runs
+bool messageShowing = false;
+const unsigned long MESSAGE_TIME = 1500; // Show for 1.5 seconds
+
+// Task names shown on the diagnostics page
+const char midiTaskName[] PROGMEM = "MIDI";
+const char inputTaskName[] PROGMEM = "Inp";
+const char displayTaskName[] PROGMEM = "Disp";
+const char holdTaskName[] PROGMEM = "Hold";
+const char timeoutTaskName[] PROGMEM = "Tout";
+const char flashTaskName[] PROGMEM = "Flsh";
+const char diagTaskName[] PROGMEM = "Diag";
+const char clockTaskName[] PROGMEM = "Clk";
+const char rateTaskName[] PROGMEM = "Rate";
+
+// Scheduled task handles
+uint8_t midiTask;
+uint8_t inputTask;
+uint8_t displayTask;
+uint8_t holdTask;
+uint8_t timeoutTask;
+uint8_t flashTask;
+uint8_t diagTask;
+uint8_t clockTask;
+uint8_t rateTask;
+
+// Interval between MIDI traffic rate samples
+const unsigned long RATE_INTERVAL = 1000;
+
+// Check whether two switches form the given chord
+bool isChord(uint8_t switchA, uint8_t switchB, uint8_t chord1, uint8_t chord2) {
+  return (switchA == chord1 && switchB == chord2) ||
+         (switchA == chord2 && switchB == chord1);
+}
+
+// Get the diagnostics page opened by a two switch chord, or NO_DIAGNOSTICS_PAGE
+const uint8_t NO_DIAGNOSTICS_PAGE = 0xFF;
+uint8_t diagnosticsChordPage(uint8_t switchA, uint8_t switchB) {
+  if (isChord(switchA, switchB, DIAG_CHORD_SWITCH_1, DIAG_CHORD_SWITCH_2)) {
+    return 0;
   }
-  
-  // Show splash screen
-  oled.showSplashScreen(DEVICE_NAME);
+  if (isChord(switchA, switchB, MIDI_CHORD_SWITCH_1, MIDI_CHORD_SWITCH_2)) {
+    return 3;
+  }
+  return NO_DIAGNOSTICS_PAGE;
+}
 
-  // Initialize footswitches
-  footswitches.begin();
+// Ask the low priority display task to redraw the footswitch labels
+void requestDisplayRefresh() {
+  // Leave a confirmation message up for its full time
+  if (!messageShowing) {
+    scheduler.startOneShot(displayTask, 0);
+  }
+}
 
-  // Initialize MIDI
-  midiController.begin();
- 
-  // Load footswitch assignments from EEPROM
-  loadFootswitchAssignments(&footswitchAssignments[0], &footswitchAssignments[1], 
-                           &footswitchAssignments[2], &footswitchAssignments[3]);
+// Keep a confirmation message on screen for MESSAGE_TIME, then redraw the labels
+void holdMessage() {
+  messageShowing = true;
+  scheduler.startOneShot(displayTask, MESSAGE_TIME);
+}
+
+// Leave programming mode and stop its timers
+void stopProgramTimers() {
+  scheduler.stop(timeoutTask);
+  scheduler.stop(flashTask);
+}
+
+// Redraw the footswitch labels, yielding to pending MIDI work
+void refreshDisplay() {
+  // Clear what is left of a confirmation message below the labels
+  if (messageShowing) {
+    messageShowing = false;
+    oled.clearMidiMessageArea();
+  }
+  
+  if (midiController.hasPendingInput()) {
+    requestDisplayRefresh();
+    return;
+  }
+
+  if (oled.inProgramMode || oled.inDiagnosticsMode) {
+    return;
+  }
 
-  // Show initial footswitch states
   oled.updateFootswitchStates(
     footswitches.getState(1),
     footswitches.getState(2),
@@ -54,140 +115,233 @@ void setup() {
   );
 }
 
-void loop() {
-  unsigned long currentTime = millis();
-  
-  // Check for footswitch state changes
-  if (footswitches.update()) {
-    // Get which switch changed
-    uint8_t changedSwitch = footswitches.getLastChanged();
-    
-    if (changedSwitch > 0) {
-      // Get the new state
-      bool newState = footswitches.getState(changedSwitch);
-      
-      // Handle programming mode
-      if (oled.inProgramMode) {
-        if (newState) { // Button pressed
-          lastProgramActionTime = currentTime; // Reset timeout
-          
-          if (changedSwitch == oled.programmingSwitch) {
-            // Cycle to next command
-            oled.selectedCommand = (oled.selectedCommand + 1) % getCommandCount();
-            oled.showProgramMode(changedSwitch, oled.selectedCommand);
-          } else {
-            // Different switch pressed - save the selected command
-            footswitchAssignments[oled.programmingSwitch - 1] = oled.selectedCommand;
-            
-            // Save to EEPROM
-            saveFootswitchAssignments(
-              footswitchAssignments[0],
-              footswitchAssignments[1],
-              footswitchAssignments[2],
-              footswitchAssignments[3]
-            );
-            
-            // Show saved confirmation
-            oled.showCommandSaved(oled.programmingSwitch, oled.selectedCommand);
-            
-            // Back to normal mode
-            oled.updateFootswitchStates(
-              footswitches.getState(1),
-              footswitches.getState(2),
-              footswitches.getState(3),
-              footswitches.getState(4)
-            );
-          }
-        }
+// Process any incoming MIDI messages, refreshing the labels if the device changed state
+void pollMidi() {
+  if (midiController.update()) {
+    requestDisplayRefresh();
+  }
+}
+
+// Send the release of a held command that already acted on its press, as its switch is now taken over
+void releaseHeldCommand() {
+  releaseFootswitch(heldSwitch);
+}
+
+// Switch held long enough - enter programming mode
+void enterProgramMode() {
+  switchBeingHeld = false;
+  releaseHeldCommand();
+
+  // Save original assignments in case user cancels
+  for (int i = 0; i < 4; i++) {
+    originalCommands[i] = footswitchAssignments[i];
+  }
+
+  // Enter programming mode
+  oled.showProgramMode(heldSwitch, footswitchAssignments[heldSwitch - 1]);
+  scheduler.startOneShot(timeoutTask, PROGRAM_TIMEOUT);
+  scheduler.startPeriodic(flashTask, FLASH_INTERVAL, FLASH_INTERVAL);
+}
+
+// No programming action for PROGRAM_TIMEOUT - cancel programming mode
+void cancelProgramMode() {
+  scheduler.stop(flashTask);
+
+  // Restore original commands
+  for (int i = 0; i < 4; i++) {
+    footswitchAssignments[i] = originalCommands[i];
+  }
+
+  // Show canceled message, then return to normal display
+  oled.showProgramCanceled();
+  holdMessage();
+}
+
+// Handle flashing in programming mode
+void flashProgramCommand() {
+  flashState = !flashState;
+  oled.flashProgramCommand(flashState);
+}
+
+// Sample the MIDI traffic counters once a second
+void updateMidiRates() {
+  midiMonitor.updateRates();
+}
+
+// Keep the diagnostics page live
+void refreshDiagnostics() {
+  oled.showDiagnostics(oled.diagnosticsPage);
+}
+
+// Show the phase error of completed quantised sends
+void reportQuantizedSends() {
+  int16_t phaseError;
+  if (clockFollower.takePhaseError(&phaseError) && !oled.inProgramMode && !oled.inDiagnosticsMode && !messageShowing) {
+    oled.showQuantizeResult(clockFollower.getTempo(), phaseError);
+  }
+}
+
+// Check for footswitch state changes
+void scanFootswitches() {
+  if (!footswitches.update()) {
+    return;
+  }
+
+  // Get which switch changed
+  uint8_t changedSwitch = footswitches.getLastChanged();
+  if (changedSwitch == 0) {
+    return;
+  }
+
+  // Get the new state
+  bool newState = footswitches.getState(changedSwitch);
+
+  // A press dismisses a confirmation message early (the redraw below covers it)
+  if (newState) {
+    messageShowing = false;
+  }
+
+  // Handle diagnostics page - any press shows the next page, then returns to normal mode
+  if (oled.inDiagnosticsMode) {
+    if (newState) {
+      if (oled.diagnosticsPage + 1 < DIAG_PAGE_COUNT) {
+        oled.showDiagnostics(oled.diagnosticsPage + 1);
+      } else {
+        scheduler.stop(diagTask);
+        oled.inDiagnosticsMode = false;
+        oled.clear();
+        requestDisplayRefresh();
       }
-      // Normal mode operation
-      else {
-        if (newState) { // Switch pressed
-          // Start tracking for hold detection
-          switchBeingHeld = true;
-          heldSwitch = changedSwitch;
-          switchHoldStartTime = currentTime;
-          
-          // Show the function name on the bottom line but don't send MIDI yet
-          oled.showFunctionPreview(footswitchAssignments[changedSwitch - 1]);
-        } 
-        else { // Switch released
-          // Check if this was the switch being held
-          if (switchBeingHeld && heldSwitch == changedSwitch) {
-            // Only send the command if the switch wasn't held long enough to enter programming
-            if (currentTime - switchHoldStartTime < HOLD_TIME_FOR_PROGRAM) {
-              // Execute the command on release instead of press
-              executeCommand(footswitchAssignments[changedSwitch - 1], true);
-              
-              // Clear the bottom line after sending command
-              oled.clearMidiMessageArea();
-            }
-            switchBeingHeld = false;
-          }
-          
-          // Handle button release for momentary commands
-          MidiCommand cmd = getCommand(footswitchAssignments[changedSwitch - 1]);
-          if (cmd.type == TYPE_CC_MOMENTARY) {
-            executeCommand(footswitchAssignments[changedSwitch - 1], false);
-          }
-        }
-        
-        // Update display
-        oled.updateFootswitchStates(
-          footswitches.getState(1),
-          footswitches.getState(2),
-          footswitches.getState(3),
-          footswitches.getState(4)
+    }
+  }
+  // Handle programming mode
+  else if (oled.inProgramMode) {
+    if (newState) { // Button pressed
+      scheduler.startOneShot(timeoutTask, PROGRAM_TIMEOUT); // Reset timeout
+
+      if (changedSwitch == oled.programmingSwitch) {
+        // Cycle to next command
+        oled.selectedCommand = (oled.selectedCommand + 1) % getCommandCount();
+        oled.showProgramMode(changedSwitch, oled.selectedCommand);
+      } else {
+        // Different switch pressed - save the selected command
+        stopProgramTimers();
+        footswitchAssignments[oled.programmingSwitch - 1] = oled.selectedCommand;
+
+        // Save to EEPROM
+        saveFootswitchAssignments(
+          footswitchAssignments[0],
+          footswitchAssignments[1],
+          footswitchAssignments[2],
+          footswitchAssignments[3]
         );
+
+        // Show saved confirmation, then back to normal mode
+        oled.showCommandSaved(oled.programmingSwitch, oled.selectedCommand);
+        holdMessage();
       }
     }
   }
-  
-  // Check for switch hold to enter programming mode
-  if (switchBeingHeld && !oled.inProgramMode) {
-    if (currentTime - switchHoldStartTime >= HOLD_TIME_FOR_PROGRAM) {
-      switchBeingHeld = false;
-      
-      // Save original assignments in case user cancels
-      for (int i = 0; i < 4; i++) {
-        originalCommands[i] = footswitchAssignments[i];
+  // Diagnostics chord - cancel the pending command and show its diagnostics page
+  else if (newState && switchBeingHeld &&
+           diagnosticsChordPage(heldSwitch, changedSwitch) != NO_DIAGNOSTICS_PAGE) {
+    switchBeingHeld = false;
+    scheduler.stop(holdTask);
+    releaseHeldCommand();
+    oled.showDiagnostics(diagnosticsChordPage(heldSwitch, changedSwitch));
+    scheduler.startPeriodic(diagTask, DIAG_REFRESH_INTERVAL, DIAG_REFRESH_INTERVAL);
+  }
+  // Normal mode operation
+  else {
+    if (newState) { // Switch pressed
+      // Start tracking for hold detection
+      switchBeingHeld = true;
+      heldSwitch = changedSwitch;
+      scheduler.startOneShot(holdTask, HOLD_TIME_FOR_PROGRAM);
+
+      // Momentary and note commands act on the press itself, others wait for the release
+      // so a hold into programming mode doesn't send them
+      if (commandActsOnPress(footswitchAssignments[changedSwitch - 1])) {
+        pressFootswitch(changedSwitch);
       }
-      
-      // Enter programming mode
-      oled.showProgramMode(heldSwitch, footswitchAssignments[heldSwitch - 1]);
-      lastProgramActionTime = currentTime;
+
+      // Show the function name on the bottom line
+      oled.showFunctionPreview(footswitchAssignments[changedSwitch - 1]);
     }
-  }
-  
-  // Check for programming mode timeout
-  if (oled.inProgramMode && (currentTime - lastProgramActionTime >= PROGRAM_TIMEOUT)) {
-    // Restore original commands
-    for (int i = 0; i < 4; i++) {
-      footswitchAssignments[i] = originalCommands[i];
+    else { // Switch released
+      // Check if this was the switch being held (the hold task clears it once programming starts)
+      if (switchBeingHeld && heldSwitch == changedSwitch) {
+        scheduler.stop(holdTask);
+
+        // Execute the command on release instead of press
+        if (!commandActsOnPress(footswitchAssignments[changedSwitch - 1])) {
+          pressFootswitch(changedSwitch);
+        }
+
+        // Clear the bottom line after sending command
+        oled.clearMidiMessageArea();
+        switchBeingHeld = false;
+      }
+
+      // Handle button release (momentary and note commands act on it, others ignore it).
+      // Presses handled by programming or diagnostics mode were never sent, so neither is their release.
+      releaseFootswitch(changedSwitch);
     }
-    
-    // Show canceled message
-    oled.showProgramCanceled();
-    
-    // Return to normal display
-    oled.updateFootswitchStates(
-      footswitches.getState(1),
-      footswitches.getState(2),
-      footswitches.getState(3),
-      footswitches.getState(4)
-    );
+
+    // Update display
+    requestDisplayRefresh();
   }
-  
-  // Handle flashing in programming mode
-  if (oled.inProgramMode && (currentTime - lastFlashTime >= FLASH_INTERVAL)) {
-    flashState = !flashState;
-    oled.flashProgramCommand(flashState);
-    lastFlashTime = currentTime;
+}
+
+void setup() {
+  // Initialize I2C for OLED
+  Wire.begin();
+
+  // Initialize the display
+  if (!oled.begin()) {
+    // If display initialization fails, we'll still continue but won't have visual feedback
   }
-  
-  // Process any incoming MIDI messages
-  midiController.update();
-  
-  // Small delay to prevent excessive CPU usage
-  delay(1);
-}
\ No newline at end of file
+
+  // Show splash screen
+  oled.showSplashScreen(DEVICE_NAME);
+
+  // Initialize footswitches
+  footswitches.begin();
+
+  // Initialize MIDI
+  midiController.begin();
+
+  // Follow incoming MIDI clock for quantised commands
+  clockFollower.begin();
+
+  // Mirror the device state of toggle and cycle commands
+  trackCommandStates();
+
+  // Load footswitch assignments from EEPROM
+  loadFootswitchAssignments(&footswitchAssignments[0], &footswitchAssignments[1],
+                           &footswitchAssignments[2], &footswitchAssignments[3]);
+
+  // Register tasks - MIDI and input run at high rate, display work yields to them
+  midiTask = scheduler.addTask(midiTaskName, pollMidi, TASK_PRIORITY_HIGH, 2);
+  inputTask = scheduler.addTask(inputTaskName, scanFootswitches, TASK_PRIORITY_HIGH, 5);
+  holdTask = scheduler.addTask(holdTaskName, enterProgramMode, TASK_PRIORITY_NORMAL, 50);
+  timeoutTask = scheduler.addTask(timeoutTaskName, cancelProgramMode, TASK_PRIORITY_NORMAL, 100);
+  displayTask = scheduler.addTask(displayTaskName, refreshDisplay, TASK_PRIORITY_LOW, 100);
+  flashTask = scheduler.addTask(flashTaskName, flashProgramCommand, TASK_PRIORITY_LOW, 100);
+  diagTask = scheduler.addTask(diagTaskName, refreshDiagnostics, TASK_PRIORITY_LOW, 100);
+  clockTask = scheduler.addTask(clockTaskName, reportQuantizedSends, TASK_PRIORITY_LOW, 100);
+  rateTask = scheduler.addTask(rateTaskName, updateMidiRates, TASK_PRIORITY_LOW, 100);
+
+  scheduler.startPeriodic(midiTask, MIDI_POLL_INTERVAL);
+  scheduler.startPeriodic(inputTask, INPUT_SCAN_INTERVAL);
+  scheduler.startPeriodic(clockTask, CLOCK_REPORT_INTERVAL);
+  scheduler.startPeriodic(rateTask, RATE_INTERVAL, RATE_INTERVAL);
+
+  // Show initial footswitch states
+  requestDisplayRefresh();
+}
+
+void loop() {
+  // Run the next due task
+  scheduler.run();
+}
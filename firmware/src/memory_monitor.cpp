@@ -0,0 +1,58 @@
+#include "memory_monitor.h"
+
+// Symbols provided by avr-libc and the linker
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern uint8_t* __brkval;
+
+MemoryMonitor memoryMonitor;
+
+// Paint all SRAM above the static data with STACK_CANARY before main() runs.
+// This runs in .init1, before the stack pointer and r1 are set up, so it is
+// written in assembly and must not touch the stack.
+void paintStack() __attribute__((naked, used, section(".init1")));
+
+void paintStack() {
+  __asm volatile (
+    "    ldi r30, lo8(_end)\n"
+    "    ldi r31, hi8(_end)\n"
+    "    ldi r24, %0\n"
+    "    ldi r25, hi8(__stack)\n"
+    "    rjmp 2f\n"
+    "1:\n"
+    "    st Z+, r24\n"
+    "2:\n"
+    "    cpi r30, lo8(__stack)\n"
+    "    cpc r31, r25\n"
+    "    brlo 1b\n"
+    "    breq 1b\n"
+    :
+    : "i" (STACK_CANARY)
+  );
+}
+
+// Lowest address the stack may grow down to (end of heap or static data)
+static uint8_t* heapEnd() {
+  return __brkval != 0 ? __brkval : &__heap_start;
+}
+
+uint16_t MemoryMonitor::getFreeRam() {
+  uint8_t top;
+  return &top - heapEnd();
+}
+
+uint16_t MemoryMonitor::getStackHighWater() {
+  return (&__stack + 1) - (heapEnd() + getStackUnused());
+}
+
+uint16_t MemoryMonitor::getStackUnused() {
+  // Count canary bytes from the top of the heap until the stack has written over them
+  uint8_t* p = heapEnd();
+  uint16_t count = 0;
+  while (p <= &__stack && *p == STACK_CANARY) {
+    p++;
+    count++;
+  }
+  return count;
+}
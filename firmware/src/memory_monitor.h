@@ -0,0 +1,24 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+
+// Byte pattern painted over unused SRAM at boot
+#define STACK_CANARY 0xC5
+
+class MemoryMonitor {
+  public:
+    // Free bytes between the heap and the stack right now
+    uint16_t getFreeRam();
+    
+    // Deepest stack use since boot, in bytes (from stack painting)
+    uint16_t getStackHighWater();
+    
+    // Bytes between the heap and the stack that have never been written,
+    // the lowest free RAM since boot including interrupts and display drawing
+    uint16_t getStackUnused();
+};
+
+extern MemoryMonitor memoryMonitor;
+
+#endif // MEMORY_MONITOR_H
@@ -1,45 +1,165 @@
 #include "midi_controller.h"
 #include "../include/config.h"
-#include "display.h"
+#include "midi_monitor.h"
 
-// Create a Serial MIDI port
-midi::SerialMIDI<HardwareSerial, MyMidiSettings> serialMIDI(Serial);
+// Create a MIDI port on the interrupt driven UART
+midi::SerialMIDI<MidiUart, MyMidiSettings> serialMIDI(midiUart);
 
-// Create instance of the MIDI interface
-midi::MidiInterface<midi::SerialMIDI<HardwareSerial, MyMidiSettings>> MIDI(serialMIDI);
+// Create instance of the MIDI interface (used for input only, output goes through sendMessage)
+midi::MidiInterface<midi::SerialMIDI<MidiUart, MyMidiSettings>> MIDI(serialMIDI);
 
 MidiController midiController;
 
 void MidiController::begin() {
-  // Initialize MIDI
+  // Initialize MIDI, this also starts the UART at the standard MIDI baud rate
   MIDI.begin(MIDI_CHANNEL_OMNI); // Listen to all channels
   
-  // We'll be using Serial for MIDI output
-  Serial.begin(31250); // Standard MIDI baud rate
+  // Don't echo the device's own messages back to it
+  MIDI.turnThruOff();
+  
+#ifdef MIDI_TX_PROFILE
+  // Free-running Timer1 at the CPU clock for cycle counts
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+#endif
 }
 
-void MidiController::sendControlChange(uint8_t controller, uint8_t value) {
-  MIDI.sendControlChange(controller, value, MIDI_CHANNEL);
-  // Display handling is now done in the main loop
+uint8_t MidiController::encodeMessage(uint8_t* message, midi::MidiType type, uint8_t channel, uint8_t data1, uint8_t data2) {
+  if (channel == 0) {
+    channel = MIDI_CHANNEL;
+  }
+  
+  message[0] = type | ((channel - 1) & 0x0F);
+  message[1] = data1 & 0x7F;
+  message[2] = data2 & 0x7F;
+  return messageLength(message[0]);
 }
 
-void MidiController::sendNote(uint8_t note, bool on, uint8_t velocity) {
-  if (on) {
-    MIDI.sendNoteOn(note, velocity, MIDI_CHANNEL);
-  } else {
-    MIDI.sendNoteOff(note, velocity, MIDI_CHANNEL);
+uint8_t MidiController::messageLength(uint8_t status) {
+  switch (status & 0xF0) {
+    case midi::ProgramChange:
+    case midi::AfterTouchChannel:
+      // Program Change and Channel Pressure carry a single data byte
+      return 2;
+    case 0xF0:
+      // System common: MTC quarter frame and song select carry one, song position two
+      switch (status) {
+        case 0xF1:
+        case 0xF3:
+          return 2;
+        case 0xF2:
+          return 3;
+        default:
+          return 1;
+      }
+    default:
+      return 3;
   }
-  // Display handling is now done in the main loop
 }
 
-void MidiController::sendProgramChange(uint8_t program) {
-  MIDI.sendProgramChange(program, MIDI_CHANNEL);
+void MidiController::sendMessage(const uint8_t* message, uint8_t length) {
+  midiUart.write(message, length);
+  midiMonitor.handleTx(message, length);
+  
+  // Walk the messages in the buffer (an NRPN is several Control Changes)
+  for (uint8_t i = 0; i < length; i += messageLength(message[i])) {
+    uint8_t type = message[i] & 0xF0;
+    uint8_t channel = (message[i] & 0x0F) + 1;
+    
+    // The device will now be in the state we just sent
+    if (type == midi::ControlChange) {
+      mirrorControlChange(channel, message[i + 1], message[i + 2]);
+    } else if (type == midi::ProgramChange) {
+      forgetDeviceStates(channel);
+    }
+  }
   // Display handling is now done in the main loop
 }
 
-void MidiController::update() {
-  // Process incoming MIDI messages (if needed)
-  if (MIDI.read()) {
-    // Handle incoming MIDI messages here if needed
+bool MidiController::update() {
+  bool stateChanged = false;
+  
+  // Mirror CC messages the device sends when it is changed from its own footswitches,
+  // a PC means it loaded another preset
+  while (MIDI.read()) {
+    switch (MIDI.getType()) {
+      case midi::ControlChange:
+        if (mirrorControlChange(MIDI.getChannel(), MIDI.getData1(), MIDI.getData2())) {
+          stateChanged = true;
+        }
+        break;
+        
+      case midi::ProgramChange:
+        if (forgetDeviceStates(MIDI.getChannel())) {
+          stateChanged = true;
+        }
+        break;
+        
+      default:
+        break;
+    }
+  }
+  
+  return stateChanged;
+}
+
+bool MidiController::hasPendingInput() {
+  return midiUart.available() > 0;
+}
+
+void MidiController::trackController(uint8_t channel, uint8_t controller) {
+  if (channel == 0) {
+    channel = MIDI_CHANNEL;
   }
-}
\ No newline at end of file
+  if (findDeviceState(channel, controller) != NULL || deviceStateCount >= DEVICE_STATE_SLOTS) {
+    return;
+  }
+  
+  deviceStates[deviceStateCount].channel = channel;
+  deviceStates[deviceStateCount].controller = controller;
+  deviceStates[deviceStateCount].value = DEVICE_STATE_UNKNOWN;
+  deviceStateCount++;
+}
+
+bool MidiController::getDeviceValue(uint8_t channel, uint8_t controller, uint8_t* value) {
+  DeviceState* state = findDeviceState(channel == 0 ? MIDI_CHANNEL : channel, controller);
+  if (state == NULL || state->value == DEVICE_STATE_UNKNOWN) {
+    return false;
+  }
+  
+  *value = state->value;
+  return true;
+}
+
+bool MidiController::forgetDeviceStates(uint8_t channel) {
+  // The new preset may be on another scene or have other settings, so nothing is known
+  // until the device reports it again
+  bool changed = false;
+  for (uint8_t i = 0; i < deviceStateCount; i++) {
+    if (deviceStates[i].channel == channel && deviceStates[i].value != DEVICE_STATE_UNKNOWN) {
+      deviceStates[i].value = DEVICE_STATE_UNKNOWN;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+MidiController::DeviceState* MidiController::findDeviceState(uint8_t channel, uint8_t controller) {
+  for (uint8_t i = 0; i < deviceStateCount; i++) {
+    if (deviceStates[i].channel == channel && deviceStates[i].controller == controller) {
+      return &deviceStates[i];
+    }
+  }
+  return NULL;
+}
+
+bool MidiController::mirrorControlChange(uint8_t channel, uint8_t controller, uint8_t value) {
+  // Only controllers used by state-tracked commands are mirrored
+  DeviceState* state = findDeviceState(channel, controller);
+  if (state == NULL || state->value == value) {
+    return false;
+  }
+  
+  state->value = value;
+  return true;
+}
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <MIDI.h>
+#include "../include/config.h"
+#include "midi_uart.h"
 
 // Create MIDI interface instance
 struct MyMidiSettings : public midi::DefaultSettings {
@@ -16,21 +18,54 @@ class MidiController {
     // Initialize MIDI functionality
     void begin();
     
-    // Send a note on/off message
-    void sendNote(uint8_t note, bool on, uint8_t velocity = 127);
+    // Fast path: queue a pre-encoded wire message straight onto the UART
+    void sendMessage(const uint8_t* message, uint8_t length);
     
-    // Send a MIDI Control Change message
-    void sendControlChange(uint8_t controller, uint8_t value);
+    // Encode a channel message into wire bytes, returns its length.
+    // Channel 0 means MIDI_CHANNEL.
+    static uint8_t encodeMessage(uint8_t* message, midi::MidiType type, uint8_t channel, uint8_t data1, uint8_t data2);
     
-    // Send a MIDI Program Change message
-    void sendProgramChange(uint8_t program);
+    // Length in bytes of a message with the given status byte (SysEx and real-time count as 1)
+    static uint8_t messageLength(uint8_t status);
     
-    // Process MIDI input (if needed)
-    void update();
+    // Process MIDI input, returns true if a mirrored device state changed
+    bool update();
+    
+    // Check whether unread MIDI input is waiting
+    bool hasPendingInput();
+    
+    // Mirror the device state for a controller (e.g. tuner, gig view), channel 0 means MIDI_CHANNEL
+    void trackController(uint8_t channel, uint8_t controller);
+    
+    // Get the last known device value for a controller, returns false if unknown
+    bool getDeviceValue(uint8_t channel, uint8_t controller, uint8_t* value);
+    
+    static const uint8_t DEVICE_STATE_UNKNOWN = 0xFF;
+    
+  private:
+    // Last known state of a controller on the device
+    struct DeviceState {
+      uint8_t channel;
+      uint8_t controller;
+      uint8_t value;
+    };
+    
+    DeviceState deviceStates[DEVICE_STATE_SLOTS];
+    uint8_t deviceStateCount = 0;
+    
+    // Find the mirror slot for a controller, or NULL if not tracked
+    DeviceState* findDeviceState(uint8_t channel, uint8_t controller);
+    
+    // Record a controller value, returns true if the mirrored value changed
+    bool mirrorControlChange(uint8_t channel, uint8_t controller, uint8_t value);
+    
+    // Mark every mirrored controller on a channel unknown after a Program Change,
+    // returns true if any was known
+    bool forgetDeviceStates(uint8_t channel);
 };
 
 extern MidiController midiController;
-extern midi::SerialMIDI<HardwareSerial, MyMidiSettings> serialMIDI;
-extern midi::MidiInterface<midi::SerialMIDI<HardwareSerial, MyMidiSettings>> MIDI;
+extern midi::SerialMIDI<MidiUart, MyMidiSettings> serialMIDI;
+extern midi::MidiInterface<midi::SerialMIDI<MidiUart, MyMidiSettings>> MIDI;
 
 #endif // MIDI_CONTROLLER_H
\ No newline at end of file
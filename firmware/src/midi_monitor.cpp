@@ -0,0 +1,149 @@
+#include "midi_monitor.h"
+#include "midi_controller.h"
+#include "midi_uart.h"
+#include <util/atomic.h>
+
+MidiMonitor midiMonitor;
+
+void MidiMonitor::handleRxByte(uint8_t value) {
+  rxBytes++;
+  
+  // Real-time bytes can appear anywhere, even inside another message
+  if (value >= 0xF8) {
+    rxMessages++;
+    addLogEntry(MIDI_DIRECTION_RX, value, 0, 0);
+    return;
+  }
+  
+  if (value & 0x80) {
+    // A status byte in the middle of a message means the message was cut short
+    if (rxDataCount > 0 || (rxSysEx && value != 0xF7)) {
+      resyncs++;
+    }
+    
+    rxLost = false;
+    rxDataCount = 0;
+    
+    if (value == 0xF0) {
+      rxSysEx = true;
+      rxStatus = 0;
+    } else if (value == 0xF7) {
+      if (rxSysEx) {
+        rxMessages++;
+        addLogEntry(MIDI_DIRECTION_RX, 0xF0, 0, 0);
+      }
+      rxSysEx = false;
+      rxStatus = 0;
+    } else {
+      rxSysEx = false;
+      rxStatus = value;
+      if (MidiController::messageLength(value) == 1) {
+        completeRxMessage();
+      }
+    }
+    return;
+  }
+  
+  if (rxSysEx) {
+    return;
+  }
+  
+  // Data byte with no status to apply it to - skip until the next status byte
+  if (rxStatus == 0) {
+    if (!rxLost) {
+      resyncs++;
+      rxLost = true;
+    }
+    return;
+  }
+  
+  rxData[rxDataCount++] = value;
+  if (rxDataCount + 1 >= MidiController::messageLength(rxStatus)) {
+    completeRxMessage();
+  }
+}
+
+void MidiMonitor::completeRxMessage() {
+  rxMessages++;
+  addLogEntry(MIDI_DIRECTION_RX, rxStatus, rxDataCount > 0 ? rxData[0] : 0, rxDataCount > 1 ? rxData[1] : 0);
+  rxDataCount = 0;
+  
+  // Channel messages keep running status, system common messages cancel it
+  if (rxStatus >= 0xF0) {
+    rxStatus = 0;
+  }
+}
+
+void MidiMonitor::handleTx(const uint8_t* message, uint8_t length) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    txBytes += length;
+    
+    // Log each message of the block separately
+    uint8_t i = 0;
+    while (i < length) {
+      uint8_t size = MidiController::messageLength(message[i]);
+      txMessages++;
+      addLogEntry(MIDI_DIRECTION_TX, message[i], size > 1 ? message[i + 1] : 0, size > 2 ? message[i + 2] : 0);
+      i += size;
+    }
+  }
+}
+
+void MidiMonitor::updateRates() {
+  // Clock and Active Sensing bytes are handled in the RX interrupt and never reach handleRxByte
+  uint16_t realtime = midiUart.takeRealtimeCount();
+  
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    rxMessageRate = rxMessages + realtime;
+    rxByteRate = rxBytes + realtime;
+    txMessageRate = txMessages;
+    txByteRate = txBytes;
+    rxMessages = rxBytes = txMessages = txBytes = 0;
+  }
+}
+
+uint16_t MidiMonitor::getRxMessageRate() {
+  return rxMessageRate;
+}
+
+uint16_t MidiMonitor::getRxByteRate() {
+  return rxByteRate;
+}
+
+uint16_t MidiMonitor::getTxMessageRate() {
+  return txMessageRate;
+}
+
+uint16_t MidiMonitor::getTxByteRate() {
+  return txByteRate;
+}
+
+uint16_t MidiMonitor::getResyncs() {
+  return resyncs;
+}
+
+bool MidiMonitor::getLogEntry(uint8_t age, LogEntry* entry) {
+  bool found = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (age < logCount) {
+      *entry = log[(logHead + MIDI_LOG_SIZE - 1 - age) % MIDI_LOG_SIZE];
+      found = true;
+    }
+  }
+  return found;
+}
+
+void MidiMonitor::addLogEntry(uint8_t direction, uint8_t status, uint8_t data1, uint8_t data2) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    LogEntry& entry = log[logHead];
+    entry.direction = direction;
+    entry.status = status;
+    entry.data1 = data1;
+    entry.data2 = data2;
+    
+    logHead = (logHead + 1) % MIDI_LOG_SIZE;
+    if (logCount < MIDI_LOG_SIZE) {
+      logCount++;
+    }
+  }
+}
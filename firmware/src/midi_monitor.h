@@ -0,0 +1,73 @@
+#ifndef MIDI_MONITOR_H
+#define MIDI_MONITOR_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Traffic direction of a logged message
+#define MIDI_DIRECTION_RX 0
+#define MIDI_DIRECTION_TX 1
+
+// Counts MIDI traffic in both directions and keeps a log of the last messages
+class MidiMonitor {
+  public:
+    // A message seen on the bus
+    struct LogEntry {
+      uint8_t direction;   // MIDI_DIRECTION_RX or MIDI_DIRECTION_TX
+      uint8_t status;
+      uint8_t data1;
+      uint8_t data2;
+    };
+    
+    // Parse a byte read from the UART, called as the MIDI library reads input
+    void handleRxByte(uint8_t value);
+    
+    // Record messages queued for output (may be called from an interrupt)
+    void handleTx(const uint8_t* message, uint8_t length);
+    
+    // Turn the counts of the last second into rates, call once a second
+    void updateRates();
+    
+    // Rates over the last second
+    uint16_t getRxMessageRate();
+    uint16_t getRxByteRate();
+    uint16_t getTxMessageRate();
+    uint16_t getTxByteRate();
+    
+    // Times the input parser lost its place (data bytes without a status, truncated messages)
+    uint16_t getResyncs();
+    
+    // Get a logged message, 0 is the most recent. Returns false if there is none.
+    bool getLogEntry(uint8_t age, LogEntry* entry);
+    
+  private:
+    // Counts for the current one second window
+    uint16_t rxMessages = 0;
+    uint16_t rxBytes = 0;
+    uint16_t txMessages = 0;
+    uint16_t txBytes = 0;
+    
+    uint16_t rxMessageRate = 0;
+    uint16_t rxByteRate = 0;
+    uint16_t txMessageRate = 0;
+    uint16_t txByteRate = 0;
+    uint16_t resyncs = 0;
+    
+    // Input parser state
+    uint8_t rxStatus = 0;       // Running status, 0 when unknown
+    uint8_t rxData[2];
+    uint8_t rxDataCount = 0;
+    bool rxLost = false;        // Discarding data bytes until the next status byte
+    bool rxSysEx = false;
+    
+    LogEntry log[MIDI_LOG_SIZE];
+    uint8_t logHead = 0;
+    uint8_t logCount = 0;
+    
+    void addLogEntry(uint8_t direction, uint8_t status, uint8_t data1, uint8_t data2);
+    void completeRxMessage();
+};
+
+extern MidiMonitor midiMonitor;
+
+#endif // MIDI_MONITOR_H
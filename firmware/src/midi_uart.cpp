@@ -0,0 +1,198 @@
+#include "midi_uart.h"
+#include "clock_follower.h"
+#include "midi_monitor.h"
+#include <util/atomic.h>
+
+MidiUart midiUart;
+
+// Buffer indices are masked, so sizes must be powers of two
+static_assert((MIDI_UART_RX_BUFFER_SIZE & (MIDI_UART_RX_BUFFER_SIZE - 1)) == 0, "RX buffer size must be a power of two");
+static_assert((MIDI_UART_TX_BUFFER_SIZE & (MIDI_UART_TX_BUFFER_SIZE - 1)) == 0, "TX buffer size must be a power of two");
+
+ISR(USART_RX_vect) {
+  midiUart.handleRxInterrupt();
+}
+
+ISR(USART_UDRE_vect) {
+  midiUart.handleTxInterrupt();
+}
+
+void MidiUart::begin(long baudRate) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    rxHead = rxTail = 0;
+    txHead = txTail = 0;
+    
+    // 31250 baud divides 16 MHz exactly, so normal speed mode is used
+    UCSR0A = 0;
+    UBRR0 = F_CPU / 16 / baudRate - 1;
+    
+    // 8 data bits, no parity, 1 stop bit
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+  }
+}
+
+uint8_t MidiUart::available() {
+  return (rxHead - rxTail) & RX_MASK;
+}
+
+uint8_t MidiUart::read() {
+  if (rxHead == rxTail) {
+    return 0;
+  }
+  
+  uint8_t value = rxBuffer[rxTail];
+  rxTail = (rxTail + 1) & RX_MASK;
+  
+  // Every byte the MIDI library reads also goes through the traffic monitor
+  midiMonitor.handleRxByte(value);
+  return value;
+}
+
+void MidiUart::write(uint8_t value) {
+  write(&value, 1);
+}
+
+void MidiUart::write(const uint8_t* data, uint8_t length) {
+  // Called with interrupts off (from an interrupt), the UDRE interrupt can't drain the queue
+  bool interruptsEnabled = SREG & _BV(SREG_I);
+  
+  bool queued = false;
+  while (!queued) {
+    // The whole message is copied in one go so messages from the main loop and
+    // from timer interrupts can't interleave on the wire
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      uint8_t depth = (txHead - txTail) & TX_MASK;
+      if (depth + length <= TX_MASK) {
+        // Nothing queued and the data register is free - start sending right away
+        if (depth == 0 && (UCSR0A & _BV(UDRE0)) && length > 0) {
+          UDR0 = *data++;
+          length--;
+        }
+        
+        while (length > 0) {
+          txBuffer[txHead] = *data++;
+          txHead = (txHead + 1) & TX_MASK;
+          length--;
+        }
+        
+        if (txHead != txTail) {
+          UCSR0B |= _BV(UDRIE0);
+        }
+        
+        depth = (txHead - txTail) & TX_MASK;
+        if (depth > txPeakDepth) {
+          txPeakDepth = depth;
+        }
+        queued = true;
+      } else if (!interruptsEnabled) {
+        // Queue full and nothing else will empty it - send a byte ourselves
+        drainOne();
+      }
+    }
+    // Otherwise wait with interrupts on, so the UDRE interrupt drains the queue
+    // and received bytes, clock ticks and timers aren't held up
+  }
+}
+
+uint8_t MidiUart::getTxQueueDepth() {
+  return (txHead - txTail) & TX_MASK;
+}
+
+uint8_t MidiUart::getTxPeakDepth() {
+  return txPeakDepth;
+}
+
+uint16_t MidiUart::getRxOverruns() {
+  uint16_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    count = rxOverruns;
+  }
+  return count;
+}
+
+uint16_t MidiUart::getRxFramingErrors() {
+  uint16_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    count = rxFramingErrors;
+  }
+  return count;
+}
+
+uint16_t MidiUart::getRxDropped() {
+  uint16_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    count = rxDropped;
+  }
+  return count;
+}
+
+uint16_t MidiUart::takeRealtimeCount() {
+  uint16_t count;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    count = realtimeCount;
+    realtimeCount = 0;
+  }
+  return count;
+}
+
+void MidiUart::drainOne() {
+  while (!(UCSR0A & _BV(UDRE0))) {
+    // Wait for the data register to empty (about 320 us per byte at 31250 baud)
+  }
+  UDR0 = txBuffer[txTail];
+  txTail = (txTail + 1) & TX_MASK;
+}
+
+void MidiUart::handleRxInterrupt() {
+  uint8_t status = UCSR0A;
+  uint8_t value = UDR0;
+  
+  // A byte arrived before the previous one was read and was lost
+  if (status & _BV(DOR0)) {
+    rxOverruns++;
+  }
+  
+  // Drop bytes with a framing error, they are line noise
+  if (status & _BV(FE0)) {
+    rxFramingErrors++;
+    return;
+  }
+  
+  // Clock, Start, Continue and Stop are timestamped here, where the timing is accurate,
+  // and don't go through the MIDI library
+  if (value == 0xF8 || (value >= 0xFA && value <= 0xFC)) {
+    clockFollower.handleRealtime(value, micros());
+    realtimeCount++;
+    return;
+  }
+  
+  // Active Sensing arrives about three times a second and nothing here uses it,
+  // so it is only counted and doesn't fill the buffer or the traffic log
+  if (value == 0xFE) {
+    realtimeCount++;
+    return;
+  }
+  
+  uint8_t next = (rxHead + 1) & RX_MASK;
+  if (next != rxTail) {
+    rxBuffer[rxHead] = value;
+    rxHead = next;
+  } else {
+    rxDropped++;
+  }
+}
+
+void MidiUart::handleTxInterrupt() {
+  if (txHead == txTail) {
+    UCSR0B &= ~_BV(UDRIE0);
+    return;
+  }
+  
+  UDR0 = txBuffer[txTail];
+  txTail = (txTail + 1) & TX_MASK;
+  
+  if (txHead == txTail) {
+    UCSR0B &= ~_BV(UDRIE0);
+  }
+}
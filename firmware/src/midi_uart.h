@@ -0,0 +1,66 @@
+#ifndef MIDI_UART_H
+#define MIDI_UART_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Interrupt driven driver for the USART the MIDI port is wired to.
+// Replaces HardwareSerial so messages can be queued as whole wire messages.
+class MidiUart {
+  public:
+    // Initialize the USART (used as the MIDI library transport)
+    void begin(long baudRate);
+    
+    // Number of received bytes waiting to be read
+    uint8_t available();
+    
+    // Read the next received byte (0 if none)
+    uint8_t read();
+    
+    // Queue a single byte (used by the MIDI library)
+    void write(uint8_t value);
+    
+    // Queue a pre-encoded message, kept contiguous even if called from an interrupt.
+    // Waits with interrupts enabled while the queue is full, length must be below MIDI_UART_TX_BUFFER_SIZE.
+    void write(const uint8_t* data, uint8_t length);
+    
+    // Number of bytes waiting to be transmitted
+    uint8_t getTxQueueDepth();
+    
+    // Link error counters for the diagnostics page
+    uint8_t getTxPeakDepth();
+    uint16_t getRxOverruns();       // Bytes lost because the USART wasn't read in time
+    uint16_t getRxFramingErrors();  // Bytes dropped with a framing error
+    uint16_t getRxDropped();        // Bytes dropped because the RX buffer was full
+    
+    // Number of real-time bytes handled in the RX interrupt since the last call
+    uint16_t takeRealtimeCount();
+    
+    // Called from the USART interrupt vectors
+    void handleRxInterrupt();
+    void handleTxInterrupt();
+    
+  private:
+    static const uint8_t RX_MASK = MIDI_UART_RX_BUFFER_SIZE - 1;
+    static const uint8_t TX_MASK = MIDI_UART_TX_BUFFER_SIZE - 1;
+    
+    volatile uint8_t rxBuffer[MIDI_UART_RX_BUFFER_SIZE];
+    volatile uint8_t rxHead = 0;
+    volatile uint8_t rxTail = 0;
+    volatile uint8_t txBuffer[MIDI_UART_TX_BUFFER_SIZE];
+    volatile uint8_t txHead = 0;
+    volatile uint8_t txTail = 0;
+    
+    volatile uint8_t txPeakDepth = 0;
+    volatile uint16_t rxOverruns = 0;
+    volatile uint16_t rxFramingErrors = 0;
+    volatile uint16_t rxDropped = 0;
+    volatile uint16_t realtimeCount = 0;
+    
+    // Send the oldest queued byte by polling (when interrupts can't drain the queue)
+    void drainOne();
+};
+
+extern MidiUart midiUart;
+
+#endif // MIDI_UART_H
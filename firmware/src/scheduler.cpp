@@ -0,0 +1,106 @@
+#include "scheduler.h"
+
+Scheduler scheduler;
+
+uint8_t Scheduler::addTask(PGM_P name, TaskCallback callback, uint8_t priority, uint8_t deadline) {
+  if (taskCount >= SCHEDULER_MAX_TASKS) {
+    return INVALID_TASK;
+  }
+  
+  Task& task = tasks[taskCount];
+  task.name = name;
+  task.callback = callback;
+  task.dueTime = 0;
+  task.period = 0;
+  task.overruns = 0;
+  task.priority = priority;
+  task.deadline = deadline;
+  task.scheduled = false;
+  
+  return taskCount++;
+}
+
+void Scheduler::startPeriodic(uint8_t task, uint16_t period, uint16_t delay) {
+  if (task < taskCount) {
+    tasks[task].period = period;
+    tasks[task].dueTime = millis() + delay;
+    tasks[task].scheduled = true;
+  }
+}
+
+void Scheduler::startOneShot(uint8_t task, uint16_t delay) {
+  startPeriodic(task, 0, delay);
+}
+
+void Scheduler::stop(uint8_t task) {
+  if (task < taskCount) {
+    tasks[task].scheduled = false;
+  }
+}
+
+bool Scheduler::isScheduled(uint8_t task) {
+  return task < taskCount && tasks[task].scheduled;
+}
+
+void Scheduler::run() {
+  unsigned long currentTime = millis();
+  
+  // Pick the highest priority due task, the most overdue one on a tie
+  Task* next = NULL;
+  unsigned long nextLateness = 0;
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task& task = tasks[i];
+    // Signed difference keeps working across millis() overflow
+    if (!task.scheduled || (long)(currentTime - task.dueTime) < 0) {
+      continue;
+    }
+    
+    unsigned long lateness = currentTime - task.dueTime;
+    if (next == NULL || task.priority > next->priority ||
+        (task.priority == next->priority && lateness > nextLateness)) {
+      next = &task;
+      nextLateness = lateness;
+    }
+  }
+  
+  if (next == NULL) {
+    return;
+  }
+  
+  // Schedule the next run before the callback, so the callback can stop or restart itself
+  if (next->period > 0) {
+    next->dueTime += next->period;
+    if ((long)(currentTime - next->dueTime) >= 0) {
+      // Fell a whole period behind - skip the missed runs
+      next->dueTime = currentTime + next->period;
+    }
+  } else {
+    next->scheduled = false;
+  }
+  
+  next->callback();
+  
+  // Count an overrun if the task started too late or ran too long
+  unsigned long runTime = millis() - currentTime;
+  if ((nextLateness > next->deadline || runTime > next->deadline) && next->overruns < 0xFFFF) {
+    next->overruns++;
+  }
+}
+
+uint8_t Scheduler::getTaskCount() {
+  return taskCount;
+}
+
+const __FlashStringHelper* Scheduler::getTaskName(uint8_t task) {
+  if (task < taskCount) {
+    return reinterpret_cast<const __FlashStringHelper*>(tasks[task].name);
+  }
+  return F("");
+}
+
+uint16_t Scheduler::getOverruns(uint8_t task) {
+  if (task < taskCount) {
+    return tasks[task].overruns;
+  }
+  return 0;
+}
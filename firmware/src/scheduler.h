@@ -0,0 +1,60 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "../include/config.h"
+
+// Task priorities - when several tasks are due the highest priority runs first
+#define TASK_PRIORITY_LOW     0
+#define TASK_PRIORITY_NORMAL  1
+#define TASK_PRIORITY_HIGH    2
+
+typedef void (*TaskCallback)();
+
+class Scheduler {
+  public:
+    // Register a task, returns its handle (or INVALID_TASK if the table is full).
+    // The deadline is the time (ms) a task may start late or run before it counts as an overrun.
+    uint8_t addTask(PGM_P name, TaskCallback callback, uint8_t priority, uint8_t deadline);
+    
+    // Run a task every period ms, first after delay ms
+    void startPeriodic(uint8_t task, uint16_t period, uint16_t delay = 0);
+    
+    // Run a task once after delay ms (restarts the timer if already scheduled)
+    void startOneShot(uint8_t task, uint16_t delay);
+    
+    // Stop a task from running
+    void stop(uint8_t task);
+    
+    // Check whether a task is waiting to run
+    bool isScheduled(uint8_t task);
+    
+    // Run the highest priority task that is due (call repeatedly from loop)
+    void run();
+    
+    // Task statistics for the diagnostics page
+    uint8_t getTaskCount();
+    const __FlashStringHelper* getTaskName(uint8_t task);
+    uint16_t getOverruns(uint8_t task);
+    
+    static const uint8_t INVALID_TASK = 0xFF;
+    
+  private:
+    struct Task {
+      PGM_P name;
+      TaskCallback callback;
+      unsigned long dueTime;
+      uint16_t period;      // 0 for one-shot tasks
+      uint16_t overruns;
+      uint8_t priority;
+      uint8_t deadline;
+      bool scheduled;
+    };
+    
+    Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t taskCount = 0;
+};
+
+extern Scheduler scheduler;
+
+#endif // SCHEDULER_H
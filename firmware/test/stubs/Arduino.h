@@ -0,0 +1,17 @@
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+// Just enough of the Arduino core for the command and MIDI code to build on the host
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+};
+
+#endif // ARDUINO_STUB_H
@@ -0,0 +1,23 @@
+#ifndef EEPROM_STUB_H
+#define EEPROM_STUB_H
+
+#include <stdint.h>
+
+// EEPROM held in RAM
+class EEPROMClass {
+  public:
+    uint8_t read(int address) {
+      return data[address];
+    }
+    
+    void write(int address, uint8_t value) {
+      data[address] = value;
+    }
+    
+  private:
+    uint8_t data[1024];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // EEPROM_STUB_H
@@ -0,0 +1,81 @@
+#ifndef MIDI_STUB_H
+#define MIDI_STUB_H
+
+// Stand-in for the FortySevenEffects MIDI Library. Input is a single message queued with inject().
+
+#include <Arduino.h>
+
+#define MIDI_CHANNEL_OMNI 0
+
+namespace midi {
+
+enum MidiType : uint8_t {
+  InvalidType = 0x00,
+  NoteOff = 0x80,
+  NoteOn = 0x90,
+  ControlChange = 0xB0,
+  ProgramChange = 0xC0,
+  AfterTouchChannel = 0xD0,
+};
+
+struct DefaultSettings {
+  static const bool UseRunningStatus = false;
+  static const bool Use1ByteParsing = true;
+};
+
+template <class Transport, class Settings>
+class SerialMIDI {
+  public:
+    explicit SerialMIDI(Transport&) {}
+};
+
+template <class Transport>
+class MidiInterface {
+  public:
+    explicit MidiInterface(Transport&) {}
+    
+    void begin(uint8_t) {}
+    void turnThruOff() {}
+    
+    // Queue a message for the next read(), as if the device had sent it
+    void inject(MidiType type, uint8_t channel, uint8_t data1, uint8_t data2) {
+      pendingType = type;
+      pendingChannel = channel;
+      pendingData1 = data1;
+      pendingData2 = data2;
+      pending = true;
+    }
+    
+    bool read() {
+      bool available = pending;
+      pending = false;
+      return available;
+    }
+    
+    MidiType getType() {
+      return pendingType;
+    }
+    
+    uint8_t getChannel() {
+      return pendingChannel;
+    }
+    
+    uint8_t getData1() {
+      return pendingData1;
+    }
+    
+    uint8_t getData2() {
+      return pendingData2;
+    }
+    
+  private:
+    bool pending = false;
+    MidiType pendingType = InvalidType;
+    uint8_t pendingChannel = 0;
+    uint8_t pendingData1 = 0;
+    uint8_t pendingData2 = 0;
+};
+
+} // namespace midi
+
+#endif // MIDI_STUB_H
@@ -0,0 +1,18 @@
+#ifndef PGMSPACE_STUB_H
+#define PGMSPACE_STUB_H
+
+// Flash and RAM share one address space on the host
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+typedef const char* PGM_P;
+
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t*>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t*>(address))
+#define pgm_read_ptr(address) (*reinterpret_cast<void* const*>(address))
+#define memcpy_P memcpy
+
+#endif // PGMSPACE_STUB_H
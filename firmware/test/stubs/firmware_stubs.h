@@ -0,0 +1,43 @@
+#ifndef FIRMWARE_STUBS_H
+#define FIRMWARE_STUBS_H
+
+// Host stand-ins for the modules behind the command code that need the AVR hardware.
+// Include from exactly one file per test suite.
+
+#include <EEPROM.h>
+#include "midi_uart.h"
+#include "midi_monitor.h"
+#include "clock_follower.h"
+
+EEPROMClass EEPROM;
+MidiUart midiUart;
+MidiMonitor midiMonitor;
+ClockFollower clockFollower;
+
+// Bytes written to the MIDI output since the last clearSent()
+uint8_t sentBytes[64];
+uint8_t sentLength = 0;
+
+void clearSent() {
+  sentLength = 0;
+}
+
+void MidiUart::write(const uint8_t* data, uint8_t length) {
+  for (uint8_t i = 0; i < length && sentLength < sizeof(sentBytes); i++) {
+    sentBytes[sentLength++] = data[i];
+  }
+}
+
+uint8_t MidiUart::available() {
+  return 0;
+}
+
+void MidiMonitor::handleTx(const uint8_t* message, uint8_t length) {
+}
+
+// No clock is running, so quantised commands are sent right away
+bool ClockFollower::schedule(const uint8_t* message, uint8_t length, uint8_t quantize) {
+  return false;
+}
+
+#endif // FIRMWARE_STUBS_H
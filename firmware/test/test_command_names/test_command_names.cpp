@@ -0,0 +1,101 @@
+// Host tests for the compressed command names: run with "pio test -e native"
+
+#include <unity.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include "command_table.h"
+#include "firmware_stubs.h"
+
+// Collects printed characters
+class CapturePrint : public Print {
+  public:
+    size_t write(uint8_t value) override {
+      text += static_cast<char>(value);
+      return 1;
+    }
+
+    std::string text;
+};
+
+// Path of a project file, found from the path this file was compiled with
+// (tests run from the project directory when that path is relative)
+static std::string projectPath(const char* relativePath) {
+  std::string path(__FILE__);
+  size_t testDir = path.rfind("test/test_command_names/");
+  return (testDir == std::string::npos ? std::string() : path.substr(0, testDir)) + relativePath;
+}
+
+// Source text of each name offset, joined from command_names.txt and the generated offsets
+static std::map<uint16_t, std::string> sourceNames;
+
+static void loadSourceNames() {
+  std::map<std::string, std::string> texts;
+  char line[128];
+
+  FILE* source = fopen(projectPath("src/command_names.txt").c_str(), "r");
+  TEST_ASSERT_TRUE_MESSAGE(source != NULL, "can't open src/command_names.txt");
+  while (fgets(line, sizeof(line), source)) {
+    std::string entry(line);
+    entry.erase(entry.find_last_not_of("\r\n") + 1);
+    size_t separator = entry.find(" = ");
+    if (entry.empty() || entry[0] == '#' || separator == std::string::npos) {
+      continue;
+    }
+    texts[entry.substr(0, separator)] = entry.substr(separator + 3);
+  }
+  fclose(source);
+
+  FILE* header = fopen(projectPath("src/command_names.h").c_str(), "r");
+  TEST_ASSERT_TRUE_MESSAGE(header != NULL, "can't open src/command_names.h");
+  char identifier[64];
+  unsigned offset;
+  while (fgets(line, sizeof(line), header)) {
+    if (sscanf(line, "const uint16_t %63s = %u;", identifier, &offset) == 2) {
+      TEST_ASSERT_TRUE_MESSAGE(texts.count(identifier) == 1, identifier);
+      sourceNames[offset] = texts[identifier];
+    }
+  }
+  fclose(header);
+}
+
+void setUp() {
+  if (sourceNames.empty()) {
+    loadSourceNames();
+  }
+}
+
+void tearDown() {
+}
+
+void test_every_name_decodes_to_its_source_text() {
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    MidiCommand cmd = getCommand(i);
+    TEST_ASSERT_TRUE(sourceNames.count(cmd.name) == 1);
+
+    CapturePrint out;
+    printCommandName(out, i);
+    TEST_ASSERT_EQUAL_STRING(sourceNames[cmd.name].c_str(), out.text.c_str());
+  }
+}
+
+void test_every_short_name_decodes_to_its_source_text() {
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    MidiCommand cmd = getCommand(i);
+    TEST_ASSERT_TRUE(sourceNames.count(cmd.shortName) == 1);
+
+    CapturePrint out;
+    printCommandShortName(out, i);
+    TEST_ASSERT_EQUAL_STRING(sourceNames[cmd.shortName].c_str(), out.text.c_str());
+
+    // Two labels share a display row
+    TEST_ASSERT_TRUE_MESSAGE(out.text.size() <= 7, out.text.c_str());
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_name_decodes_to_its_source_text);
+  RUN_TEST(test_every_short_name_decodes_to_its_source_text);
+  return UNITY_END();
+}
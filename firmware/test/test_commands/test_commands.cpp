@@ -0,0 +1,283 @@
+// Host tests for the per-type command handlers: run with "pio test -e native"
+
+#include <unity.h>
+#include "command_table.h"
+#include "midi_controller.h"
+#include "firmware_stubs.h"
+
+// Find the table entry with a type, controller and first value
+static uint8_t findCommand(CommandType type, uint8_t controller, uint8_t value1) {
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    MidiCommand cmd = getCommand(i);
+    if (cmd.type == type && cmd.controller == controller && cmd.value1 == value1) {
+      return i;
+    }
+  }
+  TEST_FAIL_MESSAGE("command not in the table");
+  return 0;
+}
+
+// Check the bytes written to the MIDI output, then clear them for the next step
+static void assertSent(const uint8_t* expected, uint8_t length) {
+  TEST_ASSERT_EQUAL_UINT8(length, sentLength);
+  if (length > 0) {
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, sentBytes, length);
+  }
+  clearSent();
+}
+
+static void assertNothingSent() {
+  assertSent(NULL, 0);
+}
+
+// Press and release a command, as the footswitch code does
+static void press(uint8_t commandIndex) {
+  executeCommand(commandIndex, true);
+}
+
+static void release(uint8_t commandIndex) {
+  executeCommand(commandIndex, false);
+}
+
+void setUp() {
+  midiController = MidiController();
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    setCommandState(i, 0);
+  }
+  trackCommandStates();
+
+  footswitchAssignments[0] = 0;
+  footswitchAssignments[1] = 1;
+  footswitchAssignments[2] = 2;
+  footswitchAssignments[3] = 3;
+  prepareFootswitchCommands();
+
+  // Drop any press a test left without its release
+  for (uint8_t switchNumber = 1; switchNumber <= 4; switchNumber++) {
+    releaseFootswitch(switchNumber);
+  }
+  clearSent();
+}
+
+void tearDown() {
+}
+
+void test_toggle_alternates_on_press() {
+  uint8_t tuner = findCommand(TYPE_CC_TOGGLE, 45, 127);
+  const uint8_t on[] = {0xB0, 45, 127};
+  const uint8_t off[] = {0xB0, 45, 0};
+
+  press(tuner);
+  assertSent(on, sizeof(on));
+  release(tuner);
+  assertNothingSent();
+  press(tuner);
+  assertSent(off, sizeof(off));
+}
+
+void test_toggle_follows_device_state() {
+  uint8_t tuner = findCommand(TYPE_CC_TOGGLE, 45, 127);
+  const uint8_t off[] = {0xB0, 45, 0};
+
+  // The device turned the tuner on from its own footswitch
+  MIDI.inject(midi::ControlChange, MIDI_CHANNEL, 45, 127);
+  TEST_ASSERT_TRUE(midiController.update());
+  TEST_ASSERT_EQUAL_UINT8(1, getCommandState(tuner));
+
+  press(tuner);
+  assertSent(off, sizeof(off));
+}
+
+void test_momentary_sends_on_press_and_release() {
+  uint8_t tunerHold = findCommand(TYPE_CC_MOMENTARY, 45, 127);
+  const uint8_t down[] = {0xB0, 45, 127};
+  const uint8_t up[] = {0xB0, 45, 0};
+
+  TEST_ASSERT_TRUE(commandActsOnPress(tunerHold));
+  press(tunerHold);
+  assertSent(down, sizeof(down));
+  release(tunerHold);
+  assertSent(up, sizeof(up));
+}
+
+void test_footswitch_release_follows_only_a_sent_press() {
+  uint8_t tunerHold = findCommand(TYPE_CC_MOMENTARY, 45, 127);
+  const uint8_t down[] = {0xB0, 45, 127};
+  const uint8_t up[] = {0xB0, 45, 0};
+  footswitchAssignments[1] = tunerHold;
+  prepareFootswitchCommands();
+
+  // The press that saves in programming mode isn't sent, so its release must not turn the tuner off
+  releaseFootswitch(2);
+  assertNothingSent();
+
+  pressFootswitch(2);
+  assertSent(down, sizeof(down));
+  releaseFootswitch(2);
+  assertSent(up, sizeof(up));
+
+  // A release is only sent once per press
+  releaseFootswitch(2);
+  assertNothingSent();
+}
+
+void test_fixed_sends_on_press_only() {
+  uint8_t sceneB = findCommand(TYPE_CC_FIXED, 43, 1);
+  const uint8_t message[] = {0xB0, 43, 1};
+
+  TEST_ASSERT_FALSE(commandActsOnPress(sceneB));
+  press(sceneB);
+  assertSent(message, sizeof(message));
+  release(sceneB);
+  assertNothingSent();
+}
+
+void test_tracked_fixed_skips_value_device_is_in() {
+  uint8_t sceneA = findCommand(TYPE_CC_FIXED, 43, 0);
+  uint8_t sceneB = findCommand(TYPE_CC_FIXED, 43, 1);
+  const uint8_t sceneAMessage[] = {0xB0, 43, 0};
+
+  // The device is already on scene B
+  MIDI.inject(midi::ControlChange, MIDI_CHANNEL, 43, 1);
+  midiController.update();
+
+  press(sceneB);
+  assertNothingSent();
+  press(sceneA);
+  assertSent(sceneAMessage, sizeof(sceneAMessage));
+
+  // Sending scene A updated the mirror, so it isn't sent twice
+  press(sceneA);
+  assertNothingSent();
+}
+
+void test_program_change_forgets_mirrored_scene() {
+  uint8_t sceneB = findCommand(TYPE_CC_FIXED, 43, 1);
+  uint8_t preset1 = findCommand(TYPE_PROGRAM_CHANGE, 0, 0);
+  const uint8_t sceneBMessage[] = {0xB0, 43, 1};
+
+  // The device is on scene B, then the board loads another preset
+  MIDI.inject(midi::ControlChange, MIDI_CHANNEL, 43, 1);
+  midiController.update();
+  press(preset1);
+  clearSent();
+
+  // The new preset may have loaded on another scene, so scene B is sent
+  press(sceneB);
+  assertSent(sceneBMessage, sizeof(sceneBMessage));
+
+  // Same when the preset is changed on the device itself
+  MIDI.inject(midi::ProgramChange, MIDI_CHANNEL, 5, 0);
+  TEST_ASSERT_TRUE(midiController.update());
+  press(sceneB);
+  assertSent(sceneBMessage, sizeof(sceneBMessage));
+}
+
+void test_cycle_steps_through_three_values() {
+  uint8_t mode = findCommand(TYPE_CC_CYCLE, 47, 1);
+  const uint8_t stomp[] = {0xB0, 47, 1};
+  const uint8_t scene[] = {0xB0, 47, 2};
+  const uint8_t preset[] = {0xB0, 47, 0};
+
+  press(mode);
+  assertSent(stomp, sizeof(stomp));
+  release(mode);
+  assertNothingSent();
+  press(mode);
+  assertSent(scene, sizeof(scene));
+  press(mode);
+  assertSent(preset, sizeof(preset));
+}
+
+void test_program_change_is_two_bytes_on_press() {
+  uint8_t preset2 = findCommand(TYPE_PROGRAM_CHANGE, 0, 1);
+  const uint8_t message[] = {0xC0, 1};
+
+  press(preset2);
+  assertSent(message, sizeof(message));
+  release(preset2);
+  assertNothingSent();
+}
+
+void test_note_on_press_off_on_release_on_own_channel() {
+  uint8_t trigger = findCommand(TYPE_NOTE, 36, 127);
+  const uint8_t noteOn[] = {0x91, 36, 127};
+  const uint8_t noteOff[] = {0x81, 36, 0};
+
+  TEST_ASSERT_TRUE(commandActsOnPress(trigger));
+  press(trigger);
+  assertSent(noteOn, sizeof(noteOn));
+  release(trigger);
+  assertSent(noteOff, sizeof(noteOff));
+}
+
+void test_nrpn_sends_four_control_changes_on_own_channel() {
+  uint8_t nrpn = findCommand(TYPE_NRPN, 0, 1);
+  const uint8_t message[] = {
+    0xB1, 99, 0,
+    0xB1, 98, 1,
+    0xB1, 6, 0,
+    0xB1, 38, 0,
+  };
+
+  press(nrpn);
+  assertSent(message, sizeof(message));
+  release(nrpn);
+  assertNothingSent();
+}
+
+void test_prepared_messages_match_encoded_ones() {
+  // Send every command once unprepared, then again from a footswitch, and compare
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    setUp();
+    press(i);
+    release(i);
+    uint8_t expected[sizeof(sentBytes)];
+    uint8_t expectedLength = sentLength;
+    memcpy(expected, sentBytes, expectedLength);
+
+    setUp();
+    footswitchAssignments[0] = i;
+    prepareFootswitchCommands();
+    press(i);
+    release(i);
+    assertSent(expected, expectedLength);
+  }
+}
+
+void test_tracked_commands_agree_on_shared_controllers() {
+  // The mirror is keyed by channel and controller, so commands sharing one must read its values the same way
+  for (uint8_t i = 0; i < getCommandCount(); i++) {
+    MidiCommand a = getCommand(i);
+    for (uint8_t j = i + 1; j < getCommandCount(); j++) {
+      MidiCommand b = getCommand(j);
+      if (!a.stateTracking || !b.stateTracking || a.channel != b.channel || a.controller != b.controller) {
+        continue;
+      }
+      if (a.type == TYPE_CC_FIXED && b.type == TYPE_CC_FIXED) {
+        continue;
+      }
+      TEST_ASSERT_EQUAL_UINT8(a.type, b.type);
+      TEST_ASSERT_EQUAL_UINT8(a.value1, b.value1);
+      TEST_ASSERT_EQUAL_UINT8(a.value2, b.value2);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_toggle_alternates_on_press);
+  RUN_TEST(test_toggle_follows_device_state);
+  RUN_TEST(test_momentary_sends_on_press_and_release);
+  RUN_TEST(test_footswitch_release_follows_only_a_sent_press);
+  RUN_TEST(test_fixed_sends_on_press_only);
+  RUN_TEST(test_tracked_fixed_skips_value_device_is_in);
+  RUN_TEST(test_program_change_forgets_mirrored_scene);
+  RUN_TEST(test_cycle_steps_through_three_values);
+  RUN_TEST(test_program_change_is_two_bytes_on_press);
+  RUN_TEST(test_note_on_press_off_on_release_on_own_channel);
+  RUN_TEST(test_nrpn_sends_four_control_changes_on_own_channel);
+  RUN_TEST(test_prepared_messages_match_encoded_ones);
+  RUN_TEST(test_tracked_commands_agree_on_shared_controllers);
+  return UNITY_END();
+}